@@ -0,0 +1,77 @@
+/*!
+ * @file asyncSelfCheck.ino
+ * @brief This demo tells how to self check a Non-contact liquid level sensor without blocking the loop.
+ * @n Experimental phenomena: The self check is started in setup, the loop keeps polling the water state while
+ * @n the self check is running, and the sensitivity and calibration mode are printed when it is finished.
+ * @n startCalibration and startSetSensitivityLevel are used in the same way.
+ *
+ * @n connected table
+ * @n --------------------------------------------------------------------------------------------------------------
+ * @n sensor pin |             MCU                | Leonardo/Mega2560/M0 |    UNO    | ESP8266 | ESP32 |  microbit  |
+ * @n     TEST   |   Not connected, floating(-1)  |               Not connected, floating(-1)          |     X      |
+ * @n     OUT    |   Not connected, floating(-1)  |               Not connected, floating(-1)          |     X      |
+ * @n     EN     | Connected to the IO pin of MCU |         2            |     2     |   D5    |  D9   |     X      |
+ * @n     VCC    |            3.3V/5V             |        VCC           |    VCC    |   VCC   |  VCC  |     X      |
+ * @n     GND    |              GND               |        GND           |    GND    |   GND   |  GND  |     X      |
+ * @n     RX     | Connected to the TX pin of MCU |     Serial1 RX1      |     5     |   D6    |  D2   |     X      |
+ * @n     TX     | Connected to the RX pin of MCU |     Serial1 TX1      |     4     |   D7    |  D3   |     X      |
+ * @n ---------------------------------------------------------------------------------------------------------------
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2021-05-14
+ * @get from https://www.dfrobot.com
+ * @url https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "DFRobot_SCW8916B.h"
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+#include <SoftwareSerial.h>
+#endif
+
+#define EN              2    /**<The IO pin of MCU which is connected to the EN pin of Non-contact liquid level sensor>*/
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+SoftwareSerial mySerial(/*rx =*/4, /*tx =*/5);
+DFRobot_SCW8916B_UART liquid(/*s =*/&mySerial, /*en =*/EN);
+#else
+DFRobot_SCW8916B_UART liquid(/*s =*/&Serial1, /*en =*/EN);
+#endif
+
+bool reported = false;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial){
+  }
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+  mySerial.begin(9600);
+#elif defined(ESP32)
+  Serial1.begin(9600, SERIAL_8N1, /*rx =*/D3, /*tx =*/D2);
+#else
+  Serial1.begin(9600);
+#endif
+
+  Serial.println("Start self check...");
+  liquid.startSelfCheck();
+}
+
+void loop() {
+  DFRobot_Nilometer::eOpState_t state = liquid.step();   /**<Advance the self check, never blocks.*/
+  if(!reported && state == DFRobot_Nilometer::eOpDone){
+      reported = true;
+      Serial.print("Current sensitivity level(0~7): ");
+      Serial.println(liquid.getSensitivity());
+      Serial.println(liquid.getCalibModeDescription(liquid.getCalibrationMode()));
+  }else if(!reported && state == DFRobot_Nilometer::eOpFailed){
+      reported = true;
+      Serial.println("Self check failed, please check the connection of EN, RX and TX pin.");
+  }
+
+  if(liquid.poll()){                                     /**<Detection keeps running at the same time.*/
+      Serial.print("Water state: ");
+      Serial.println(liquid.lastState());
+  }
+}
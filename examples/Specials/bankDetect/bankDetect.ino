@@ -0,0 +1,54 @@
+/*!
+ * @file bankDetect.ino
+ * @brief This demo tells how to sample a bank of Non-contact liquid level sensors in level one-to-one detection mode 
+ * @n at once by DFRobot_SCW8916B_IOBank.
+ * @n Experimental phenomena: Whenever the water state of a sensor changes, the index and the water state of the 
+ * @n sensor are printed. The OUT pins 2~7 of Uno are all on PORTD, so every service is one read of the PIND register.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2021-05-14
+ * @get from https://www.dfrobot.com
+ * @url https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "DFRobot_SCW8916B.h"
+#include "DFRobot_SCW8916B_IOBank.h"
+
+#define TANKS  6
+
+DFRobot_SCW8916B_IO tank[TANKS] = {
+  DFRobot_SCW8916B_IO(/*out =*/2), DFRobot_SCW8916B_IO(/*out =*/3), DFRobot_SCW8916B_IO(/*out =*/4),
+  DFRobot_SCW8916B_IO(/*out =*/5), DFRobot_SCW8916B_IO(/*out =*/6), DFRobot_SCW8916B_IO(/*out =*/7)
+};
+
+DFRobot_SCW8916B_IOBank<TANKS> bank;
+
+void onChange(uint8_t index, uint8_t channels){
+  Serial.print("Sensor ");
+  Serial.print(index);
+  Serial.print(" water state: ");
+  Serial.println(channels);
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  Serial.print("Initialization sensors...");
+  for(uint8_t i = 0; i < TANKS; i++){
+      while(tank[i].begin() != 0){
+          Serial.print(".");
+          delay(1000);
+      }
+      bank.addSensor(&tank[i]);
+  }
+  Serial.println("done.");
+  Serial.print("Port reads per service: ");
+  Serial.println(bank.portCount());
+  bank.setCallback(onChange);
+}
+
+void loop() {
+  bank.service();                                        /**<Sample all sensors by one read of each port, never blocks.*/
+}
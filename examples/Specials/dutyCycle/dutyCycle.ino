@@ -0,0 +1,83 @@
+/*!
+ * @file dutyCycle.ino
+ * @brief This demo tells how to read a Non-contact liquid level sensor on a battery: the sensor is powered through
+ * @n EN only for one sample every SAMPLE_PERIOD, instead of streaming frames all the time.
+ * @n Experimental phenomena: Every SAMPLE_PERIOD the sensor is powered on, the water state of the first valid frame
+ * @n is printed with the powered time of the sample and the learned warm-up time, then the sensor is powered off.
+ * @n The average supply current is about the sensor current times the on time divided by SAMPLE_PERIOD.
+ *
+ * @n connected table
+ * @n --------------------------------------------------------------------------------------------------------------
+ * @n sensor pin |             MCU                | Leonardo/Mega2560/M0 |    UNO    | ESP8266 | ESP32 |  microbit  |
+ * @n     TEST   |   Not connected, floating(-1)  |               Not connected, floating(-1)          |     X      |
+ * @n     OUT    |   Not connected, floating(-1)  |               Not connected, floating(-1)          |     X      |
+ * @n     EN     | Connected to the IO pin of MCU |         2            |     2     |   D5    |  D9   |     X      |
+ * @n     VCC    |            3.3V/5V             |        VCC           |    VCC    |   VCC   |  VCC  |     X      |
+ * @n     GND    |              GND               |        GND           |    GND    |   GND   |  GND  |     X      |
+ * @n     RX     | Connected to the TX pin of MCU |     Serial1 RX1      |     5     |   D6    |  D2   |     X      |
+ * @n     TX     | Connected to the RX pin of MCU |     Serial1 TX1      |     4     |   D7    |  D3   |     X      |
+ * @n ---------------------------------------------------------------------------------------------------------------
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2021-05-14
+ * @get from https://www.dfrobot.com
+ * @url https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "DFRobot_SCW8916B.h"
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+#include <SoftwareSerial.h>
+#endif
+
+#define EN              2       /**<The IO pin of MCU which is connected to the EN pin of Non-contact liquid level sensor>*/
+#define SAMPLE_PERIOD   60000   /**<Time between two samples, unit: ms>*/
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+SoftwareSerial mySerial(/*rx =*/4, /*tx =*/5);
+DFRobot_SCW8916B_UART liquid(/*s =*/&mySerial, /*en =*/EN);
+#else
+DFRobot_SCW8916B_UART liquid(/*s =*/&Serial1, /*en =*/EN);
+#endif
+
+uint32_t sampleTime = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial){
+  }
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+  mySerial.begin(9600);
+#elif defined(ESP32)
+  Serial1.begin(9600, SERIAL_8N1, /*rx =*/D3, /*tx =*/D2);
+#else
+  Serial1.begin(9600);
+#endif
+  sampleTime = millis() - SAMPLE_PERIOD;
+}
+
+void loop() {
+  const DFRobot_Nilometer::sSampleStats_t *stats;
+  if(millis() - sampleTime < SAMPLE_PERIOD){
+      return;                                        /**<The sensor is off, the MCU could sleep here.*/
+  }
+  sampleTime = millis();
+  stats = liquid.getSampleStats();
+  if(liquid.sample()){
+      Serial.print("Water state: ");
+      Serial.print(liquid.lastState());
+  }else{
+      Serial.print("No valid frame, please check the connection of EN, RX and TX pin and the calibration");
+  }
+  Serial.print(", on ");
+  Serial.print(stats->lastOnTime);
+  Serial.print(" ms, warm-up ");
+  Serial.print(stats->warmup);
+  Serial.print(" ms, total on ");
+  Serial.print(stats->onTime);
+  Serial.print(" ms in ");
+  Serial.print(stats->samples + stats->failures);
+  Serial.println(" samples");
+}
@@ -0,0 +1,98 @@
+/*!
+ * @file levelGauge.ino
+ * @brief This demo tells how to turn the 4 channels of a sensor, mounted one above the other on a tank, into one
+ * @n level reading with fill rate and time to full/empty by DFRobot_SCW8916B_Gauge.
+ * @n Experimental phenomena: Whenever the water crosses a channel, the level is printed. Every second the estimated
+ * @n level, the fill rate and the time to full or empty are printed from the gauge without asking the sensor.
+ * @n A channel which is wet above a dry channel is reported as inconsistent and ignored.
+ *
+ * @n connected table in eUARTDetecteMode(not support microbit)
+ * ---------------------------------------------------------------------------------------------------------------
+ * sensor pin |             MCU                | Leonardo/Mega2560/M0 |    UNO    | ESP8266 | ESP32 |  microbit  |
+ *     TEST   |    Not connected, floating     |               Not connected, floating(-1)          |     X      |
+ *     OUT    |    Not connected, floating     |               Not connected, floating(-1)          |     X      |
+ *     EN     |    Not connected, floating(-1) |               Not connected, floating(-1)          |     X      |
+ *     VCC    |            3.3V/5V             |        VCC           |    VCC    |   VCC   |  VCC  |     X      |
+ *     GND    |              GND               |        GND           |    GND    |   GND   |  GND  |     X      |
+ *     RX     |              TX                |     Serial1 RX1      |     5     |5/D6(TX) |  D2   |     X      |
+ *     TX     |              RX                |     Serial1 TX1      |     4     |4/D7(RX) |  D3   |     X      |
+ * ---------------------------------------------------------------------------------------------------------------
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2021-05-14
+ * @get from https://www.dfrobot.com
+ * @url https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "DFRobot_SCW8916B.h"
+#include "DFRobot_SCW8916B_Gauge.h"
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+#include <SoftwareSerial.h>
+#endif
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+SoftwareSerial mySerial(/*rx =*/4, /*tx =*/5);
+DFRobot_SCW8916B_UART liquid(/*s =*/&mySerial);
+#else
+DFRobot_SCW8916B_UART liquid(/*s =*/&Serial1);
+#endif
+
+const uint16_t heights[4] = {50, 150, 250, 350};        /**<Height of channel 1~4 above the bottom of the tank, unit: mm.*/
+DFRobot_SCW8916B_Gauge<4> gauge;
+uint32_t printTime = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial){
+  }
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+  mySerial.begin(9600);
+#elif defined(ESP32)
+  Serial1.begin(9600, SERIAL_8N1, /*rx =*/D3, /*tx =*/D2);
+#else
+  Serial1.begin(9600);
+#endif
+
+  Serial.print("Initialization sensor...");
+  while(liquid.begin() != 0){
+      Serial.print(".");
+      delay(1000);
+  }
+  Serial.println("done.");
+  gauge.begin(heights);
+}
+
+void loop() {
+  if(liquid.poll()){
+      if(gauge.updateChannels(liquid.lastChannels(), millis())){
+          Serial.print("Level: ");
+          Serial.print(gauge.level());
+          Serial.println(" mm");
+      }else if(!gauge.consistent()){
+          Serial.println("Inconsistent channels, ignored.");
+      }
+  }
+
+  if(gauge.valid() && (millis() - printTime > 1000)){      /**<Read the cached level, the sensor is not asked.*/
+      uint32_t now = millis();
+      printTime = now;
+      Serial.print("Estimate: ");
+      Serial.print(gauge.estimate(now));
+      Serial.print(" mm, rate: ");
+      Serial.print(gauge.rate(now));
+      Serial.print(" um/s");
+      if(gauge.timeToFull(now) != GAUGE_NO_ESTIMATE){
+          Serial.print(", full in ");
+          Serial.print(gauge.timeToFull(now));
+          Serial.print(" s");
+      }else if(gauge.timeToEmpty(now) != GAUGE_NO_ESTIMATE){
+          Serial.print(", empty in ");
+          Serial.print(gauge.timeToEmpty(now));
+          Serial.print(" s");
+      }
+      Serial.println();
+  }
+}
@@ -0,0 +1,55 @@
+/*!
+ * @file multiSensor.ino
+ * @brief This demo tells how to watch several Non-contact liquid level sensors from one loop by DFRobot_SCW8916B_Manager.
+ * @n Experimental phenomena: Whenever the water state of a sensor changes, the index and the water state mask of the 
+ * @n sensor are printed. The loop is never blocked, no matter how many sensors are added.
+ * @n Sensor 0 is in UART detection mode on Serial1, sensor 1 and 2 are in level one-to-one detection mode.
+ *
+ * @n note: This demo needs a board with Serial1, for example Leonardo, Mega2560 or M0.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2021-05-14
+ * @get from https://www.dfrobot.com
+ * @url https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "DFRobot_SCW8916B.h"
+#include "DFRobot_SCW8916B_Manager.h"
+
+DFRobot_SCW8916B_UART tank0(/*s =*/&Serial1);
+DFRobot_SCW8916B_IO   tank1(/*out =*/10);
+DFRobot_SCW8916B_IO   tank2(/*out =*/11);
+
+DFRobot_SCW8916B_Manager<3> manager;
+
+void onChange(uint8_t index, uint8_t channels){
+  Serial.print("Sensor ");
+  Serial.print(index);
+  Serial.print(" water state: ");
+  Serial.println(channels, BIN);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial){
+  }
+  Serial1.begin(9600);
+
+  Serial.print("Initialization sensors...");
+  while(tank0.begin() != 0 || tank1.begin() != 0 || tank2.begin() != 0){
+      Serial.print(".");
+      delay(1000);
+  }
+  Serial.println("done.");
+
+  manager.addSensor(&tank0);
+  manager.addSensor(&tank1);
+  manager.addSensor(&tank2);
+  manager.setCallback(onChange);
+}
+
+void loop() {
+  manager.service();                                     /**<Poll all sensors once, never blocks.*/
+}
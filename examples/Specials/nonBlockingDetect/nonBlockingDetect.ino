@@ -0,0 +1,84 @@
+/*!
+ * @file nonBlockingDetect.ino
+ * @brief This demo tells how to detect water without blocking the loop by poll, available and lastState.
+ * @n Experimental phenomena: The water state is printed only when a new state arrives, and the LED_BUILTIN of MCU
+ * @n keeps blinking at the same time, which shows that the loop is never blocked by the sensor.
+ *
+ * @n connected table in eUARTDetecteMode(not support microbit)
+ * ---------------------------------------------------------------------------------------------------------------
+ * sensor pin |             MCU                | Leonardo/Mega2560/M0 |    UNO    | ESP8266 | ESP32 |  microbit  |
+ *     TEST   |    Not connected, floating     |               Not connected, floating(-1)          |     X      |
+ *     OUT    |    Not connected, floating     |               Not connected, floating(-1)          |     X      |
+ *     EN     |    Not connected, floating(-1) |               Not connected, floating(-1)          |     X      |
+ *     VCC    |            3.3V/5V             |        VCC           |    VCC    |   VCC   |  VCC  |     X      |
+ *     GND    |              GND               |        GND           |    GND    |   GND   |  GND  |     X      |
+ *     RX     |              TX                |     Serial1 RX1      |     5     |5/D6(TX) |  D2   |     X      |
+ *     TX     |              RX                |     Serial1 TX1      |     4     |4/D7(RX) |  D3   |     X      |
+ * ---------------------------------------------------------------------------------------------------------------
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @data  2021-05-14
+ * @get from https://www.dfrobot.com
+ * @url https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "DFRobot_SCW8916B.h"
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+#include <SoftwareSerial.h>
+#endif
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+SoftwareSerial mySerial(/*rx =*/4, /*tx =*/5);
+DFRobot_SCW8916B_UART liquid(/*s =*/&mySerial);
+#else
+DFRobot_SCW8916B_UART liquid(/*s =*/&Serial1);
+#endif
+
+uint32_t blinkTime = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial){
+  }
+
+  pinMode(LED_BUILTIN, OUTPUT);
+
+#if defined(ARDUINO_AVR_UNO)||defined(ESP8266)
+  mySerial.begin(9600);
+#elif defined(ESP32)
+  Serial1.begin(9600, SERIAL_8N1, /*rx =*/D3, /*tx =*/D2);
+#else
+  Serial1.begin(9600);
+#endif
+
+  Serial.print("Initialization sensor...");
+  int error = 0;
+  while((error = liquid.begin()) != 0){
+      Serial.print("failed. \nError code: ");
+      Serial.println(error);
+      if(error == ERR_CALIBRATION_CODE){
+          Serial.println("You need to use calibration.ino to calibration sensor.");
+      }else{
+          Serial.println("Please check whether the hardware connection or configuration parameter is wrong.");
+      }
+      delay(1000);
+      Serial.print("Initialization sensor...");
+  }
+  Serial.println("done.");
+}
+
+void loop() {
+  liquid.poll();                                         /**<Consume the received frames, never blocks.*/
+  if(liquid.available()){
+      bool flag = liquid.lastState();                    /**<true: have water, false: no water.*/
+      Serial.print(flag ? "Have water: " : "No water:   ");
+      Serial.println(flag);
+  }
+
+  if(millis() - blinkTime > 500){                        /**<Other work of the loop keeps running.*/
+      blinkTime = millis();
+      digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+}
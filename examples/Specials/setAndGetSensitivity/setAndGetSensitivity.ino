@@ -81,7 +81,11 @@ void setup() {
       Serial.print("Initialization sensor...");
   }
   Serial.println("done.");
-  
+
+/**
+ * @brief Start a configuration session, setSensitivityLevel and selfCheck share one power cycle of the sensor.
+ */
+  liquid.beginSession();
   Serial.print("Set sensitivity level...");
 /**
  * @brief Set sensitivity level of the channel of sensor.The higher the sensitivity level, the lower the sensitivity.Ranging 0~7.
@@ -136,6 +140,7 @@ void setup() {
  * @n     0xFF                   : Error sensitivity level value
  */
   Serial.println(liquid.getSensitivity());
+  liquid.endSession();
 }
 
 void loop() {
@@ -0,0 +1,168 @@
+/*!
+ * @file Arduino.h
+ * @brief Minimal Arduino core shim, which is used to build the library on a Linux host.
+ * @n Time is a virtual clock by default: delay() advances it and runs every registered clock listener(emulated
+ * @n sensors, serial lines...) up to the new time, so a 8s begin() costs microseconds of wall time.
+ * @n Pin I/O is forwarded to a pluggable HostGpio backend.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __HOST_ARDUINO_H
+#define __HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+
+#ifndef ARDUINO
+#define ARDUINO 10813
+#endif
+
+#define HIGH    0x1
+#define LOW     0x0
+
+#define INPUT          0x0
+#define OUTPUT         0x1
+#define INPUT_PULLUP   0x2
+
+#define CHANGE   1
+#define FALLING  2
+#define RISING   3
+
+#define NOT_A_PIN        0
+#define NOT_AN_INTERRUPT -1
+
+#define HOST_MAX_PINS    64
+#define HOST_PORT_PINS   32   /**<Pins of an emulated GPIO port, pin n is bit(n % 32) of port(n / 32)*/
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+void interrupts(void);
+void noInterrupts(void);
+
+#define digitalPinToInterrupt(p)  ((p) < HOST_MAX_PINS ? (int)(p) : NOT_AN_INTERRUPT)
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+#define digitalPinToPort(p)     ((uint8_t)((p) / HOST_PORT_PINS))
+#define digitalPinToBitMask(p)  ((uint32_t)1 << ((p) % HOST_PORT_PINS))
+
+/**
+ * @brief Pluggable pin backend, the default backend is a plain pin table.
+ */
+class HostGpio{
+public:
+  virtual ~HostGpio(){}
+  virtual void pinMode(uint8_t pin, uint8_t mode) = 0;
+  virtual void digitalWrite(uint8_t pin, uint8_t val) = 0;
+  virtual int  digitalRead(uint8_t pin) = 0;
+/**
+ * @brief Read the input levels of a whole port at once, bit n is pin(port * HOST_PORT_PINS + n).
+ * @n The default reads the pins one by one, a backend with a real port register can override it.
+ */
+  virtual uint32_t readPort(uint8_t port){
+    uint32_t val = 0;
+    for(uint8_t i = 0; i < HOST_PORT_PINS; i++){
+        uint16_t pin = (uint16_t)port * HOST_PORT_PINS + i;
+        if(pin >= HOST_MAX_PINS) break;
+        if(digitalRead(pin)) val |= (uint32_t)1 << i;
+    }
+    return val;
+  }
+};
+
+/**
+ * @brief Anything which produces events on the virtual time line(emulated sensors, serial lines).
+ */
+class HostClockListener{
+public:
+  virtual ~HostClockListener(){}
+/**
+ * @brief The time of the next scheduled event, unit: us. Return UINT64_MAX if nothing is scheduled.
+ */
+  virtual uint64_t nextEventUs() = 0;
+/**
+ * @brief The virtual clock has reached nowUs, process every event which is due.
+ */
+  virtual void onClock(uint64_t nowUs) = 0;
+};
+
+/**
+ * @brief Select the pin backend, NULL restores the default pin table.
+ */
+void hostSetGpio(HostGpio *gpio);
+HostGpio *hostGetGpio(void);
+/**
+ * @brief Read an input port through the pin backend(the mock of the port input register of an MCU).
+ */
+uint32_t hostReadPort(uint8_t port);
+/**
+ * @brief The number of hostReadPort calls since hostReset.
+ */
+uint32_t hostPortReads(void);
+/**
+ * @brief Report a level change of an input pin, the attached interrupt of the pin is called.
+ * @n Every pin backend which drives a pin(emulated sensors) must call it on each edge.
+ */
+void hostPinChanged(uint8_t pin, uint8_t level);
+/**
+ * @brief Register or unregister a listener of the virtual clock.
+ */
+void hostAddClockListener(HostClockListener *l);
+void hostRemoveClockListener(HostClockListener *l);
+/**
+ * @brief Current host time, unit: us.
+ */
+uint64_t hostNowUs(void);
+/**
+ * @brief Advance the virtual clock by us, every listener event on the way is delivered in order.
+ */
+void hostAdvanceUs(uint64_t us);
+/**
+ * @brief Switch between the virtual clock(default) and the monotonic clock of the host.
+ */
+void hostUseRealClock(bool real);
+/**
+ * @brief Reset the virtual clock to 0 and drop every listener.
+ */
+void hostReset(void);
+
+class String{
+public:
+  String(const char *s = ""):_str(s ? s : ""){}
+  String(const std::string &s):_str(s){}
+  String(int v):_str(std::to_string(v)){}
+  String(unsigned int v):_str(std::to_string(v)){}
+  String(long v):_str(std::to_string(v)){}
+  String(unsigned long v):_str(std::to_string(v)){}
+  const char *c_str() const { return _str.c_str(); }
+  unsigned int length() const { return _str.length(); }
+  String &operator+=(const String &rhs){ _str += rhs._str; return *this; }
+  String operator+(const String &rhs) const { return String(_str + rhs._str); }
+  bool operator==(const String &rhs) const { return _str == rhs._str; }
+  bool operator==(const char *rhs) const { return _str == rhs; }
+private:
+  std::string _str;
+};
+
+#include "Stream.h"
+
+#endif
@@ -0,0 +1,202 @@
+/*!
+ * @file HostArduino.cpp
+ * @brief Virtual clock and pin table of the host Arduino shim.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "Arduino.h"
+#include <time.h>
+
+#define HOST_MAX_LISTENERS  64
+
+class HostPinTable: public HostGpio{
+public:
+  HostPinTable(){ memset(_level, 0, sizeof(_level)); }
+  void pinMode(uint8_t pin, uint8_t mode){
+    if((pin < HOST_MAX_PINS) && (mode == INPUT_PULLUP)) _level[pin] = HIGH;
+  }
+  void digitalWrite(uint8_t pin, uint8_t val){
+    if(pin >= HOST_MAX_PINS) return;
+    val = val ? HIGH : LOW;
+    if(_level[pin] != val){
+        _level[pin] = val;
+        hostPinChanged(pin, val);
+    }
+  }
+  int digitalRead(uint8_t pin){
+    return (pin < HOST_MAX_PINS) ? _level[pin] : LOW;
+  }
+private:
+  uint8_t _level[HOST_MAX_PINS];
+};
+
+static HostPinTable       _pinTable;
+static HostGpio          *_gpio = &_pinTable;
+static HostClockListener *_listeners[HOST_MAX_LISTENERS];
+static uint8_t            _listenerCount = 0;
+static uint64_t           _nowUs = 0;
+static bool               _realClock = false;
+static uint64_t           _realEpochUs = 0;
+static void             (*_isr[HOST_MAX_PINS])(void);
+static int                _isrMode[HOST_MAX_PINS];
+static bool               _interrupts = true;
+static uint32_t           _portReads = 0;
+
+static uint64_t monotonicUs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+void hostSetGpio(HostGpio *gpio){
+  _gpio = (gpio != NULL) ? gpio : &_pinTable;
+}
+
+HostGpio *hostGetGpio(void){
+  return _gpio;
+}
+
+uint32_t hostReadPort(uint8_t port){
+  _portReads++;
+  return _gpio->readPort(port);
+}
+
+uint32_t hostPortReads(void){
+  return _portReads;
+}
+
+void hostPinChanged(uint8_t pin, uint8_t level){
+  if(pin >= HOST_MAX_PINS || _isr[pin] == NULL || !_interrupts) return;
+  if((_isrMode[pin] == CHANGE) || (_isrMode[pin] == RISING && level) || (_isrMode[pin] == FALLING && !level)){
+      _isr[pin]();
+  }
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode){
+  if(interruptNum >= HOST_MAX_PINS) return;
+  _isr[interruptNum] = userFunc;
+  _isrMode[interruptNum] = mode;
+}
+
+void detachInterrupt(uint8_t interruptNum){
+  if(interruptNum >= HOST_MAX_PINS) return;
+  _isr[interruptNum] = NULL;
+}
+
+void hostAddClockListener(HostClockListener *l){
+  if(l == NULL || _listenerCount >= HOST_MAX_LISTENERS) return;
+  for(uint8_t i = 0; i < _listenerCount; i++){
+      if(_listeners[i] == l) return;
+  }
+  _listeners[_listenerCount++] = l;
+}
+
+void hostRemoveClockListener(HostClockListener *l){
+  for(uint8_t i = 0; i < _listenerCount; i++){
+      if(_listeners[i] == l){
+          _listeners[i] = _listeners[--_listenerCount];
+          return;
+      }
+  }
+}
+
+uint64_t hostNowUs(void){
+  if(_realClock){
+      return monotonicUs() - _realEpochUs;
+  }
+  return _nowUs;
+}
+
+static void runListeners(uint64_t now){
+  for(uint8_t i = 0; i < _listenerCount; i++){
+      _listeners[i]->onClock(now);
+  }
+}
+
+void hostAdvanceUs(uint64_t us){
+  if(_realClock){
+      uint64_t end = hostNowUs() + us;
+      struct timespec ts;
+      ts.tv_sec = us / 1000000ULL;
+      ts.tv_nsec = (us % 1000000ULL) * 1000;
+      nanosleep(&ts, NULL);
+      runListeners(end);
+      return;
+  }
+  uint64_t target = _nowUs + us;
+  while(1){
+      uint64_t next = target;
+      for(uint8_t i = 0; i < _listenerCount; i++){
+          uint64_t t = _listeners[i]->nextEventUs();
+          if(t < next) next = t;
+      }
+      if(next > _nowUs) _nowUs = next;
+      runListeners(_nowUs);
+      if(_nowUs >= target) break;
+  }
+}
+
+void hostUseRealClock(bool real){
+  if(real && !_realClock){
+      _realEpochUs = monotonicUs() - _nowUs;
+  }else if(!real && _realClock){
+      _nowUs = hostNowUs();
+  }
+  _realClock = real;
+}
+
+void hostReset(void){
+  _nowUs = 0;
+  _listenerCount = 0;
+  _realClock = false;
+  _gpio = &_pinTable;
+  _pinTable = HostPinTable();
+  _interrupts = true;
+  _portReads = 0;
+  memset(_isr, 0, sizeof(_isr));
+}
+
+void pinMode(uint8_t pin, uint8_t mode){
+  _gpio->pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val){
+  _gpio->digitalWrite(pin, val);
+}
+
+int digitalRead(uint8_t pin){
+  return _gpio->digitalRead(pin);
+}
+
+unsigned long millis(void){
+  return (unsigned long)(hostNowUs() / 1000ULL);
+}
+
+unsigned long micros(void){
+  return (unsigned long)hostNowUs();
+}
+
+void delay(unsigned long ms){
+  hostAdvanceUs((uint64_t)ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us){
+  hostAdvanceUs(us);
+}
+
+void yield(void){
+  runListeners(hostNowUs());
+}
+
+void interrupts(void){
+  _interrupts = true;
+}
+
+void noInterrupts(void){
+  _interrupts = false;
+}
@@ -0,0 +1,36 @@
+/*!
+ * @file HostFileStore.cpp
+ * @brief Snapshot store of the host build, the snapshot is kept in a file instead of EEPROM.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "HostFileStore.h"
+#include <stdio.h>
+
+bool HostFileStore::read(void *buf, uint8_t len){
+  FILE *fp = fopen(_path.c_str(), "rb");
+  if(fp == NULL) return false;
+  size_t n = fread(buf, 1, len, fp);
+  fclose(fp);
+  return n == len;
+}
+
+bool HostFileStore::write(const void *buf, uint8_t len){
+  uint8_t old[256];
+  if(read(old, len) && memcmp(old, buf, len) == 0) return true;
+  FILE *fp = fopen(_path.c_str(), "wb");
+  if(fp == NULL) return false;
+  size_t n = fwrite(buf, 1, len, fp);
+  fclose(fp);
+  _writes++;
+  return n == len;
+}
+
+void HostFileStore::erase(){
+  remove(_path.c_str());
+}
@@ -0,0 +1,42 @@
+/*!
+ * @file HostFileStore.h
+ * @brief Snapshot store of the host build, the snapshot is kept in a file instead of EEPROM.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __HOST_FILE_STORE_H
+#define __HOST_FILE_STORE_H
+
+#include "DFRobot_SCW8916B_Store.h"
+#include <string>
+
+class HostFileStore: public DFRobot_SCW8916B_Store{
+public:
+/**
+ * @brief HostFileStore constructor.
+ * @param path  The file of the snapshot, it is created by the first write.
+ */
+  HostFileStore(const char *path):_path(path),_writes(0){}
+
+  bool read(void *buf, uint8_t len);
+  bool write(const void *buf, uint8_t len);
+/**
+ * @brief Delete the file.
+ */
+  void erase();
+/**
+ * @brief The number of writes which changed the file, like the wear of EEPROM.
+ */
+  uint32_t writes(){ return _writes; }
+
+private:
+  std::string _path;
+  uint32_t _writes;
+};
+
+#endif
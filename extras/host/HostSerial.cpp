@@ -0,0 +1,66 @@
+/*!
+ * @file HostSerial.cpp
+ * @brief Serial port of the host build.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "HostSerial.h"
+
+HostSerial::HostSerial(uint16_t rxSize)
+  :_size(rxSize ? rxSize : 1),_head(0),_count(0),_baud(9600),_sink(NULL)
+{
+  _buf = new uint8_t[_size];
+  resetCounters();
+}
+
+HostSerial::~HostSerial(){
+  delete[] _buf;
+}
+
+void HostSerial::resetCounters(){
+  _delivered = 0;
+  _read = 0;
+  _written = 0;
+  _overflowed = 0;
+}
+
+bool HostSerial::deliver(uint8_t val){
+  if(_count >= _size){
+      _overflowed++;
+      return false;
+  }
+  _buf[(_head + _count) % _size] = val;
+  _count++;
+  _delivered++;
+  return true;
+}
+
+int HostSerial::available(){
+  yield();
+  return _count;
+}
+
+int HostSerial::read(){
+  if(_count == 0) return -1;
+  uint8_t val = _buf[_head];
+  _head = (_head + 1) % _size;
+  _count--;
+  _read++;
+  return val;
+}
+
+int HostSerial::peek(){
+  if(_count == 0) return -1;
+  return _buf[_head];
+}
+
+size_t HostSerial::write(uint8_t val){
+  _written++;
+  if(_sink != NULL) _sink->onTx(val);
+  return 1;
+}
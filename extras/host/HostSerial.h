@@ -0,0 +1,73 @@
+/*!
+ * @file HostSerial.h
+ * @brief Serial port of the host build. The MCU side is a Stream, the other side is a HostSerialSink
+ * @n (an emulated sensor) which receives the bytes written by the MCU and delivers bytes to the receive buffer.
+ * @n The receive buffer has a fixed capacity like a real UART, the bytes which do not fit are counted and dropped.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __HOST_SERIAL_H
+#define __HOST_SERIAL_H
+
+#include "Arduino.h"
+
+#define HOST_SERIAL_RX_SIZE   64   /**<Default receive buffer size, the same as the AVR HardwareSerial*/
+
+class HostSerialSink{
+public:
+  virtual ~HostSerialSink(){}
+/**
+ * @brief A byte which is written by the MCU.
+ */
+  virtual void onTx(uint8_t val) = 0;
+};
+
+class HostSerial: public Stream{
+public:
+  HostSerial(uint16_t rxSize = HOST_SERIAL_RX_SIZE);
+  ~HostSerial();
+
+  void begin(uint32_t baud){ _baud = baud; }
+  uint32_t baud(){ return _baud; }
+/**
+ * @brief The time of one byte on the line(start + 8 data + stop bits), unit: us.
+ */
+  uint32_t byteTimeUs(){ return 10000000UL / _baud; }
+  void setSink(HostSerialSink *sink){ _sink = sink; }
+/**
+ * @brief Deliver a byte to the receive buffer, it is dropped if the buffer is full.
+ * @return true: stored, false: dropped.
+ */
+  bool deliver(uint8_t val);
+
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t val);
+  using Print::write;
+
+  uint32_t bytesDelivered(){ return _delivered; }
+  uint32_t bytesRead(){ return _read; }
+  uint32_t bytesWritten(){ return _written; }
+  uint32_t bytesOverflowed(){ return _overflowed; }
+  void resetCounters();
+
+private:
+  uint8_t *_buf;
+  uint16_t _size;
+  uint16_t _head;
+  uint16_t _count;
+  uint32_t _baud;
+  HostSerialSink *_sink;
+  uint32_t _delivered;
+  uint32_t _read;
+  uint32_t _written;
+  uint32_t _overflowed;
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*!
+ * @file SCW8916B_Emulator.cpp
+ * @brief Software model of the SCW8916B Non-contact liquid level sensor for the host build.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "SCW8916B_Emulator.h"
+
+#define EMU_MS                    1000ULL
+#define EMU_NEVER                 UINT64_MAX
+#define EMU_UNCALIB_TOGGLE_AFTER  (8000 * EMU_MS)
+#define EMU_UNCALIB_TOGGLE_PERIOD (100 * EMU_MS)
+#define EMU_PATTERN_HIGH          (600 * EMU_MS)
+#define EMU_SELF_CHECK_PULSE_MS   400
+#define EMU_CALIB_PULSE_MIN_MS    50
+#define EMU_CALIB_PULSE_MAX_MS    300
+
+sSCW8916BEmulatorConfig_t SCW8916B_Emulator::defaultConfig(){
+  sSCW8916BEmulatorConfig_t cfg;
+  cfg.en = -1;
+  cfg.out = -1;
+  cfg.test = -1;
+  cfg.levelMode = false;
+  cfg.calibrated = true;
+  cfg.calibMode = 0;
+  cfg.channels = 1;
+  cfg.bootMs = 300;
+  cfg.framePeriodMs = 100;
+  cfg.replyMs = 5;
+  cfg.calibMs = 300;
+  return cfg;
+}
+
+SCW8916B_Emulator::SCW8916B_Emulator(HostSerial *serial, const sSCW8916BEmulatorConfig_t &cfg)
+  :_serial(serial),_cfg(cfg),_nextGpio(NULL),_attached(false),_lineFreeUs(0),_powered(false),
+   _powerOnUs(0),_nextFrameUs(EMU_NEVER),_rxLen(0),_testLevel(HIGH),_testLowUs(0),_patternStartUs(0),
+   _patternLowMs(0),_lastOut(LOW),_powerCycles(0),_framesSent(0)
+{
+  memset(_signal, 0, sizeof(_signal));
+  memset(_sen, 3, sizeof(_sen));
+}
+
+SCW8916B_Emulator::~SCW8916B_Emulator(){
+  detach();
+}
+
+void SCW8916B_Emulator::attach(){
+  if(_attached) return;
+  _attached = true;
+  _nextGpio = hostGetGpio();
+  hostSetGpio(this);
+  hostAddClockListener(this);
+  if(_serial != NULL) _serial->setSink(this);
+  // EN has a pull-up, the sensor runs until the MCU pulls EN low.
+  powerOn(hostNowUs());
+}
+
+void SCW8916B_Emulator::detach(){
+  if(!_attached) return;
+  _attached = false;
+  if(hostGetGpio() == this) hostSetGpio(_nextGpio);
+  hostRemoveClockListener(this);
+  if(_serial != NULL) _serial->setSink(NULL);
+}
+
+void SCW8916B_Emulator::setWater(uint8_t ch, bool water){
+  setSignal(ch, water ? 255 : 0);
+}
+
+void SCW8916B_Emulator::setSignal(uint8_t ch, uint8_t signal){
+  _signal[ch & 0x03] = signal;
+  checkOut(hostNowUs());
+}
+
+void SCW8916B_Emulator::checkOut(uint64_t now){
+  uint8_t level = outLevel(now);
+  if(level == _lastOut) return;
+  _lastOut = level;
+  if(_attached && _cfg.out >= 0) hostPinChanged(_cfg.out, level);
+}
+
+void SCW8916B_Emulator::inject(uint8_t val){
+  send(hostNowUs(), val);
+}
+
+uint8_t SCW8916B_Emulator::channelMask(){
+  uint8_t mask = 0;
+  for(uint8_t i = 0; i < _cfg.channels && i < 4; i++){
+      if(_signal[i] >= 16 + _sen[i] * 32) mask |= 1 << i;
+  }
+  return mask;
+}
+
+uint8_t SCW8916B_Emulator::selfCheckValue(){
+  return (_cfg.levelMode ? 0x01 : 0x00) | ((_cfg.calibMode & 0x01) << 1) |
+         ((_cfg.channels & 0x07) << 2) | ((_sen[0] & 0x07) << 5);
+}
+
+void SCW8916B_Emulator::powerOn(uint64_t now){
+  _powered = true;
+  _powerOnUs = now;
+  _nextFrameUs = now + _cfg.bootMs * EMU_MS;
+  _rxLen = 0;
+  _powerCycles++;
+}
+
+void SCW8916B_Emulator::powerOff(){
+  _powered = false;
+  _tx.clear();
+  _nextFrameUs = EMU_NEVER;
+  _patternStartUs = 0;
+}
+
+bool SCW8916B_Emulator::booted(uint64_t now){
+  return _powered && (now >= _powerOnUs + _cfg.bootMs * EMU_MS);
+}
+
+void SCW8916B_Emulator::send(uint64_t at, uint8_t val){
+  sTxByte_t b;
+  uint32_t byteUs = _serial ? _serial->byteTimeUs() : 1042;
+  uint64_t start = (at > _lineFreeUs) ? at : _lineFreeUs;
+  b.at = start + byteUs;
+  b.val = val;
+  _lineFreeUs = b.at;
+  _tx.push_back(b);
+}
+
+uint8_t SCW8916B_Emulator::outLevel(uint64_t now){
+  if(!_powered) return LOW;
+  if(_patternStartUs){
+      uint64_t t = now - _patternStartUs;
+      if(t < _patternLowMs * EMU_MS) return LOW;
+      if(t < _patternLowMs * EMU_MS + EMU_PATTERN_HIGH) return HIGH;
+  }
+  if(!_cfg.calibrated){
+      uint64_t t = now - _powerOnUs;
+      if(t < EMU_UNCALIB_TOGGLE_AFTER) return LOW;
+      return (((t - EMU_UNCALIB_TOGGLE_AFTER) / EMU_UNCALIB_TOGGLE_PERIOD) & 0x01) ? LOW : HIGH;
+  }
+  return (channelMask() & 0x01) ? HIGH : LOW;
+}
+
+uint64_t SCW8916B_Emulator::nextOutEdge(uint64_t now){
+  if(!_powered || _cfg.out < 0) return EMU_NEVER;
+  if(_patternStartUs){
+      uint64_t low = _patternStartUs + _patternLowMs * EMU_MS;
+      if(now < low) return low;
+      return low + EMU_PATTERN_HIGH;
+  }
+  if(!_cfg.calibrated){
+      uint64_t start = _powerOnUs + EMU_UNCALIB_TOGGLE_AFTER;
+      if(now < start) return start;
+      return start + ((now - start) / EMU_UNCALIB_TOGGLE_PERIOD + 1) * EMU_UNCALIB_TOGGLE_PERIOD;
+  }
+  return EMU_NEVER;
+}
+
+uint64_t SCW8916B_Emulator::nextEventUs(){
+  uint64_t next = EMU_NEVER;
+  uint64_t now = hostNowUs();
+  if(!_tx.empty()) next = _tx.front().at;
+  if(_powered && !_cfg.levelMode && _cfg.framePeriodMs && _nextFrameUs < next) next = _nextFrameUs;
+  uint64_t edge = nextOutEdge(now);
+  if(edge < next) next = edge;
+  return next;
+}
+
+void SCW8916B_Emulator::onClock(uint64_t now){
+  if(_powered && !_cfg.levelMode && _cfg.framePeriodMs){
+      while(_nextFrameUs <= now){
+          uint8_t mask = channelMask();
+          send(_nextFrameUs, _cfg.calibrated ? (uint8_t)(((~mask) << 4) | mask) : 0xAA);
+          _framesSent++;
+          _nextFrameUs += _cfg.framePeriodMs * EMU_MS;
+      }
+  }
+  while(!_tx.empty() && _tx.front().at <= now){
+      if(_serial != NULL) _serial->deliver(_tx.front().val);
+      _tx.pop_front();
+  }
+  if(_patternStartUs && now >= _patternStartUs + _patternLowMs * EMU_MS + EMU_PATTERN_HIGH){
+      _patternStartUs = 0;
+  }
+  checkOut(now);
+}
+
+void SCW8916B_Emulator::pinMode(uint8_t pin, uint8_t mode){
+  if(_nextGpio != NULL) _nextGpio->pinMode(pin, mode);
+}
+
+void SCW8916B_Emulator::digitalWrite(uint8_t pin, uint8_t val){
+  uint64_t now = hostNowUs();
+  if(_nextGpio != NULL) _nextGpio->digitalWrite(pin, val);
+  if(_cfg.en >= 0 && pin == _cfg.en){
+      if(val && !_powered) powerOn(now);
+      else if(!val && _powered) powerOff();
+  }else if(_cfg.test >= 0 && pin == _cfg.test){
+      if(!val && _testLevel){
+          _testLowUs = now;
+      }else if(val && !_testLevel && _powered){
+          uint32_t ms = (uint32_t)((now - _testLowUs) / EMU_MS);
+          if(ms >= EMU_SELF_CHECK_PULSE_MS){
+              uint8_t v = selfCheckValue();
+              send(now + _cfg.replyMs * EMU_MS, v);
+              send(now + _cfg.replyMs * EMU_MS, (uint8_t)~v);
+          }else if(ms >= EMU_CALIB_PULSE_MIN_MS && ms <= EMU_CALIB_PULSE_MAX_MS){
+              _patternStartUs = now;
+              _patternLowMs = ms;
+              _cfg.calibrated = true;
+          }
+      }
+      _testLevel = val ? HIGH : LOW;
+  }
+  checkOut(now);
+}
+
+int SCW8916B_Emulator::digitalRead(uint8_t pin){
+  if(_cfg.out >= 0 && pin == _cfg.out){
+      return outLevel(hostNowUs());
+  }
+  return (_nextGpio != NULL) ? _nextGpio->digitalRead(pin) : LOW;
+}
+
+void SCW8916B_Emulator::onTx(uint8_t val){
+  uint64_t now = hostNowUs();
+  if(!booted(now)) return;
+  handleCommand(now, val);
+}
+
+void SCW8916B_Emulator::handleCommand(uint64_t now, uint8_t val){
+  uint64_t at = now + (_serial ? _serial->byteTimeUs() : 0) + _cfg.replyMs * EMU_MS;
+  if(_rxLen){
+      _rx[_rxLen++] = val;
+      if(_rxLen < sizeof(_rx)) return;
+      _rxLen = 0;
+      if((uint8_t)(_rx[1] + _rx[2] + _rx[3] + _rx[4]) != _rx[5]) return;
+      for(uint8_t i = 0; i < 4; i++){
+          _sen[i] = _rx[1 + i] & 0x07;
+      }
+      send(at, 0x53);
+      return;
+  }
+  switch(val){
+      case 0x34:{
+        uint8_t v = selfCheckValue();
+        send(at, v);
+        send(at, (uint8_t)~v);
+        break;
+      }
+      case 0x25:
+      case 0x8A:
+        _cfg.calibrated = true;
+        send(at + _cfg.calibMs * EMU_MS, (uint8_t)((val >> 4) | (val << 4)));
+        break;
+      case 0x43:
+        _rx[0] = val;
+        _rxLen = 1;
+        break;
+      default:
+        break;
+  }
+}
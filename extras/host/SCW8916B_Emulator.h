@@ -0,0 +1,131 @@
+/*!
+ * @file SCW8916B_Emulator.h
+ * @brief Software model of the SCW8916B Non-contact liquid level sensor for the host build.
+ * @n UART protocol:
+ * @n 1. detection frame every framePeriodMs: low nibble is the channel mask, high nibble is its complement,
+ * @n    or 0xAA if the sensor has never been calibrated;
+ * @n 2. 0x34 self check, reply {value, ~value}, value = outs | topt << 1 | chan << 2 | sen << 5;
+ * @n 3. 0x25/0x8A calibration, reply the nibble swapped command(0x52/0xA8) after calibMs;
+ * @n 4. {0x43, l1, l2, l3, l4, cs} sensitivity, cs = l1 + l2 + l3 + l4, reply 0x53.
+ * @n Level one-to-one detection mode:
+ * @n 1. OUT follows channel 1, an uncalibrated sensor toggles OUT every 100ms from 8s after power on;
+ * @n 2. a TEST low pulse of 50~300ms starts the calibration: OUT is low for the pulse time, then high for 600ms;
+ * @n 3. a TEST low pulse of 400ms or longer starts the self check: the self-check pair is sent on TX.
+ * @n Every OUT edge is reported to hostPinChanged at its exact virtual time, so attached interrupts fire.
+ * @n A channel is wet when its signal(0~255) reaches the threshold of its sensitivity level,
+ * @n threshold = 16 + level * 32, so level 0 is the most sensitive and level 7 the least.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __SCW8916B_EMULATOR_H
+#define __SCW8916B_EMULATOR_H
+
+#include "Arduino.h"
+#include "HostSerial.h"
+#include <deque>
+
+typedef struct{
+  int en;                   /**<EN pin, -1: not connected(always powered)*/
+  int out;                  /**<OUT pin, -1: not connected*/
+  int test;                 /**<TEST pin, -1: not connected*/
+  bool levelMode;           /**<false: UART detection mode(outs = 0), true: level one-to-one detection mode(outs = 1)*/
+  bool calibrated;          /**<The sensor has been calibrated*/
+  uint8_t calibMode;        /**<topt: CALIBRATION_MODE_LOWER_LEVEL or CALIBRATION_MODE_LOWER_AND_UPPER_LEVEL*/
+  uint8_t channels;         /**<chan: number of channels, 1~4*/
+  uint32_t bootMs;          /**<Power on to the first frame or command, unit: ms*/
+  uint32_t framePeriodMs;   /**<Detection frame period, 0: no detection frames, unit: ms*/
+  uint32_t replyMs;         /**<Command processing time, unit: ms*/
+  uint32_t calibMs;         /**<Calibration time before the ack, unit: ms*/
+}sSCW8916BEmulatorConfig_t;
+
+class SCW8916B_Emulator: public HostClockListener, public HostGpio, public HostSerialSink{
+public:
+/**
+ * @brief Default configuration: UART mode, calibrated, 1 channel, pins not connected, 9600 baud frames every 100ms.
+ */
+  static sSCW8916BEmulatorConfig_t defaultConfig();
+
+  SCW8916B_Emulator(HostSerial *serial, const sSCW8916BEmulatorConfig_t &cfg);
+  ~SCW8916B_Emulator();
+/**
+ * @brief Connect to the virtual clock, the pin backend and the serial port, detach undoes it.
+ * @n Emulators attach in a chain, pins which do not belong to an emulator go to the previous backend.
+ */
+  void attach();
+  void detach();
+
+  void setWater(uint8_t ch, bool water);
+  void setSignal(uint8_t ch, uint8_t signal);
+  uint8_t getSignal(uint8_t ch){ return _signal[ch & 0x03]; }
+  void setCalibrated(bool calibrated){ _cfg.calibrated = calibrated; checkOut(hostNowUs()); }
+  bool isCalibrated(){ return _cfg.calibrated; }
+  void setFramePeriod(uint32_t ms){ _cfg.framePeriodMs = ms; }
+  uint8_t getSensitivity(uint8_t ch){ return _sen[ch & 0x03]; }
+  void setSensitivity(uint8_t ch, uint8_t level){ _sen[ch & 0x03] = level & 0x07; checkOut(hostNowUs()); }
+  bool isPowered(){ return _powered; }
+/**
+ * @brief Inject a raw byte on the TX line, for example a corrupt byte.
+ */
+  void inject(uint8_t val);
+/**
+ * @brief The channel mask which is reported now.
+ */
+  uint8_t channelMask();
+  uint32_t powerCycles(){ return _powerCycles; }
+  uint32_t framesSent(){ return _framesSent; }
+  const sSCW8916BEmulatorConfig_t &config(){ return _cfg; }
+
+  /* HostClockListener */
+  uint64_t nextEventUs();
+  void onClock(uint64_t nowUs);
+  /* HostGpio */
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  int  digitalRead(uint8_t pin);
+  /* HostSerialSink */
+  void onTx(uint8_t val);
+
+private:
+  void powerOn(uint64_t now);
+  void powerOff();
+  bool booted(uint64_t now);
+  void send(uint64_t at, uint8_t val);
+  void handleCommand(uint64_t now, uint8_t val);
+  uint8_t outLevel(uint64_t now);
+  uint64_t nextOutEdge(uint64_t now);
+  uint8_t selfCheckValue();
+  void checkOut(uint64_t now);
+
+  typedef struct{
+    uint64_t at;
+    uint8_t val;
+  }sTxByte_t;
+
+  HostSerial *_serial;
+  sSCW8916BEmulatorConfig_t _cfg;
+  HostGpio *_nextGpio;
+  bool _attached;
+  std::deque<sTxByte_t> _tx;
+  uint64_t _lineFreeUs;
+  bool _powered;
+  uint64_t _powerOnUs;
+  uint64_t _nextFrameUs;
+  uint8_t _signal[4];
+  uint8_t _sen[4];
+  uint8_t _rx[6];
+  uint8_t _rxLen;
+  uint8_t _testLevel;
+  uint64_t _testLowUs;
+  uint64_t _patternStartUs;  /**<Start of the OUT calibration pattern, 0: no pattern*/
+  uint32_t _patternLowMs;
+  uint8_t _lastOut;          /**<The last OUT level which is reported to hostPinChanged*/
+  uint32_t _powerCycles;
+  uint32_t _framesSent;
+};
+
+#endif
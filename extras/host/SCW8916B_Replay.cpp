@@ -0,0 +1,191 @@
+/*!
+ * @file SCW8916B_Replay.cpp
+ * @brief Replay a trace of DFRobot_SCW8916B_Trace through the unchanged library on the virtual clock.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "SCW8916B_Replay.h"
+#include <stdio.h>
+
+SCW8916B_Replay::SCW8916B_Replay()
+  :_nextGpio(NULL),_attached(false)
+{
+  reset();
+}
+
+SCW8916B_Replay::~SCW8916B_Replay(){
+  detach();
+}
+
+void SCW8916B_Replay::reset(){
+  _input.clear();
+  _output.clear();
+  _rx.clear();
+  _next = 0;
+  _expect = 0;
+  _us = 0;
+  _ext = 0;
+  _tickUs = SCW8916B_TRACE_TICK_US;
+  _durationUs = 0;
+  _startUs = 0;
+  _dropped = 0;
+  _mismatches = 0;
+  memset(_level, 0, sizeof(_level));
+  memset(_inPin, 0, sizeof(_inPin));
+  memset(_outPin, 0, sizeof(_outPin));
+}
+
+void SCW8916B_Replay::add(uint32_t dt, uint8_t type, uint8_t val){
+  sEvent_t ev;
+  uint8_t pin = val >> 1;
+  if(type == eTraceTime){
+      _ext += (uint64_t)dt << 16;
+      return;
+  }
+  _us += (_ext + dt) * _tickUs;
+  _ext = 0;
+  _durationUs = _us;
+  ev.us = _us;
+  ev.type = type;
+  ev.val = val;
+  if(type == eTraceRx){
+      _input.push_back(ev);
+  }else if(type == eTracePinRead){
+      if(pin < HOST_MAX_PINS && !_inPin[pin]){
+          _inPin[pin] = true;
+          _level[pin] = val & 0x01;
+      }
+      _input.push_back(ev);
+  }else if(type == eTraceTx || type == eTracePinWrite){
+      if(type == eTracePinWrite && pin < HOST_MAX_PINS) _outPin[pin] = true;
+      _output.push_back(ev);
+  }
+}
+
+bool SCW8916B_Replay::load(const char *path){
+  FILE *fp = fopen(path, "rb");
+  uint8_t header[sizeof(sTraceHeader_t)];
+  bool ok = false;
+  if(fp == NULL) return false;
+  reset();
+  while(fread(header, 1, sizeof(header), fp) == sizeof(header)){
+      uint16_t count = header[6] | (header[7] << 8);
+      if(memcmp(header, "SCWT", 4) != 0 || header[4] != SCW8916B_TRACE_VERSION || header[5] == 0){
+          ok = false;
+          break;
+      }
+      _tickUs = header[5];
+      _dropped += header[8] | (header[9] << 8) | (header[10] << 16) | ((uint32_t)header[11] << 24);
+      ok = true;
+      for(uint16_t i = 0; i < count; i++){
+          uint8_t rec[4];
+          if(fread(rec, 1, sizeof(rec), fp) != sizeof(rec)){
+              ok = false;
+              break;
+          }
+          add(rec[0] | (rec[1] << 8), rec[2], rec[3]);
+      }
+      if(!ok) break;
+  }
+  fclose(fp);
+  return ok;
+}
+
+void SCW8916B_Replay::load(const DFRobot_SCW8916B_Trace &trace){
+  reset();
+  for(uint16_t i = 0; i < trace.count(); i++){
+      const sTraceRecord_t *rec = trace.get(i);
+      add(rec->dt, rec->type, rec->val);
+  }
+  _dropped = trace.dropped();
+}
+
+void SCW8916B_Replay::attach(){
+  if(_attached) return;
+  _attached = true;
+  _startUs = hostNowUs();
+  _nextGpio = hostGetGpio();
+  hostSetGpio(this);
+  hostAddClockListener(this);
+  onClock(_startUs);
+}
+
+void SCW8916B_Replay::detach(){
+  if(!_attached) return;
+  _attached = false;
+  if(hostGetGpio() == this) hostSetGpio(_nextGpio);
+  hostRemoveClockListener(this);
+}
+
+uint64_t SCW8916B_Replay::nextEventUs(){
+  return done() ? UINT64_MAX : _startUs + _input[_next].us;
+}
+
+void SCW8916B_Replay::onClock(uint64_t nowUs){
+  while(!done() && _startUs + _input[_next].us <= nowUs){
+      const sEvent_t &ev = _input[_next++];
+      if(ev.type == eTraceRx){
+          _rx.push_back(ev.val);
+      }else{
+          uint8_t pin = ev.val >> 1;
+          uint8_t level = ev.val & 0x01;
+          if(pin < HOST_MAX_PINS && _level[pin] != level){
+              _level[pin] = level;
+              hostPinChanged(pin, level);
+          }
+      }
+  }
+}
+
+void SCW8916B_Replay::expect(uint8_t type, uint8_t val){
+  if(_expect >= _output.size() || _output[_expect].type != type){
+      _mismatches++;
+      return;
+  }
+  if(_output[_expect].val != val) _mismatches++;
+  _expect++;
+}
+
+void SCW8916B_Replay::pinMode(uint8_t pin, uint8_t mode){
+  if(pin < HOST_MAX_PINS && (_inPin[pin] || _outPin[pin])) return;
+  if(_nextGpio != NULL) _nextGpio->pinMode(pin, mode);
+}
+
+void SCW8916B_Replay::digitalWrite(uint8_t pin, uint8_t val){
+  if(pin < HOST_MAX_PINS && _outPin[pin]){
+      expect(eTracePinWrite, (uint8_t)((pin << 1) | (val ? 1 : 0)));
+      return;
+  }
+  if(_nextGpio != NULL) _nextGpio->digitalWrite(pin, val);
+}
+
+int SCW8916B_Replay::digitalRead(uint8_t pin){
+  if(pin < HOST_MAX_PINS && _inPin[pin]) return _level[pin];
+  return (_nextGpio != NULL) ? _nextGpio->digitalRead(pin) : LOW;
+}
+
+int SCW8916B_Replay::available(){
+  return _rx.size();
+}
+
+int SCW8916B_Replay::read(){
+  int val;
+  if(_rx.empty()) return -1;
+  val = _rx.front();
+  _rx.pop_front();
+  return val;
+}
+
+int SCW8916B_Replay::peek(){
+  return _rx.empty() ? -1 : _rx.front();
+}
+
+size_t SCW8916B_Replay::write(uint8_t val){
+  expect(eTraceTx, val);
+  return 1;
+}
@@ -0,0 +1,105 @@
+/*!
+ * @file SCW8916B_Replay.h
+ * @brief Replay a trace of DFRobot_SCW8916B_Trace through the unchanged library on the virtual clock.
+ * @n The replay is the serial port and the pin backend of the library: the recorded received bytes and OUT levels
+ * @n are delivered at their recorded times, the bytes and the levels which the library writes are compared with
+ * @n the recorded ones in order. The virtual clock jumps from event to event, so hours of traffic replay in milliseconds.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __SCW8916B_REPLAY_H
+#define __SCW8916B_REPLAY_H
+
+#include "Arduino.h"
+#include "DFRobot_SCW8916B_Trace.h"
+#include <deque>
+#include <vector>
+
+class SCW8916B_Replay: public HostClockListener, public HostGpio, public Stream{
+public:
+  SCW8916B_Replay();
+  ~SCW8916B_Replay();
+/**
+ * @brief Load a trace file(one or more blocks which are written by DFRobot_SCW8916B_Trace::dump).
+ * @return true: sucess, false: the file can not be read or is not a trace.
+ */
+  bool load(const char *path);
+/**
+ * @brief Load the records of a trace in memory.
+ */
+  void load(const DFRobot_SCW8916B_Trace &trace);
+/**
+ * @brief Start the replay at the current virtual time: connect to the virtual clock and the pin backend,
+ * @n detach undoes it. Pins which are not in the trace go to the previous backend.
+ */
+  void attach();
+  void detach();
+/**
+ * @brief Every recorded input has been delivered.
+ */
+  bool done(){ return _next >= _input.size(); }
+/**
+ * @brief The number of records which were lost by the ring buffer before the trace was dumped.
+ */
+  uint32_t dropped(){ return _dropped; }
+  uint32_t inputs(){ return _input.size(); }
+  uint32_t outputs(){ return _output.size(); }
+/**
+ * @brief Bytes or pin levels written by the library which differ from the trace, or which are not in the trace.
+ */
+  uint32_t mismatches(){ return _mismatches; }
+/**
+ * @brief The recorded duration of the trace, unit: us.
+ */
+  uint64_t durationUs(){ return _durationUs; }
+
+  /* HostClockListener */
+  uint64_t nextEventUs();
+  void onClock(uint64_t nowUs);
+  /* HostGpio */
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  int  digitalRead(uint8_t pin);
+  /* Stream */
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t val);
+  using Print::write;
+
+private:
+  typedef struct{
+    uint64_t us;       /**<Time since the start of the trace*/
+    uint8_t type;      /**<eTraceType_t*/
+    uint8_t val;
+  }sEvent_t;
+
+  void reset();
+  void add(uint32_t dt, uint8_t type, uint8_t val);
+  void expect(uint8_t type, uint8_t val);
+
+  std::vector<sEvent_t> _input;     /**<eTraceRx and eTracePinRead*/
+  std::vector<sEvent_t> _output;    /**<eTraceTx and eTracePinWrite*/
+  size_t _next;
+  size_t _expect;
+  std::deque<uint8_t> _rx;
+  uint8_t _level[HOST_MAX_PINS];
+  bool _inPin[HOST_MAX_PINS];       /**<The pin is read in the trace, its level comes from the trace*/
+  bool _outPin[HOST_MAX_PINS];      /**<The pin is written in the trace, its levels are compared*/
+  uint64_t _us;                     /**<Time of the last loaded record, unit: us*/
+  uint64_t _ext;                    /**<Pending eTraceTime ticks*/
+  uint8_t _tickUs;
+  uint64_t _durationUs;
+  uint64_t _startUs;
+  uint32_t _dropped;
+  uint32_t _mismatches;
+  HostGpio *_nextGpio;
+  bool _attached;
+};
+
+#endif
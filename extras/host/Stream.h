@@ -0,0 +1,49 @@
+/*!
+ * @file Stream.h
+ * @brief Minimal Print/Stream shim for the host build.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __HOST_STREAM_H
+#define __HOST_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class Print{
+public:
+  virtual ~Print(){}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size){
+    size_t n = 0;
+    while(size--){
+        if(write(*buffer++)) n++;
+        else break;
+    }
+    return n;
+  }
+  size_t write(const char *str){ return write((const uint8_t *)str, strlen(str)); }
+  virtual void flush(){}
+};
+
+class Stream: public Print{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(uint8_t *buffer, size_t length){
+    size_t n = 0;
+    while(n < length && available()){
+        buffer[n++] = (uint8_t)read();
+    }
+    return n;
+  }
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*!
+ * @file scw8916b_bench.cpp
+ * @brief Latency and throughput benchmark of every public API against the emulated sensor on the virtual clock.
+ * @n Every operation is run in both detection modes, across baud rates and frame periods. One JSON object is
+ * @n printed per line:
+ * @n {"mode","op","baud","frame_ms","iterations","result","virtual_ms","wall_us","bytes_consumed","bytes_discarded"}
+ * @n virtual_ms and wall_us are the mean cost of one call, the byte counters are totals of all iterations.
+ * @n bytes_discarded counts the bytes which were read from the serial port but were neither a valid frame nor a reply.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <stdio.h>
+#include <chrono>
+#include "DFRobot_SCW8916B.h"
+#include "SCW8916B_Emulator.h"
+
+#define EN     2
+#define OUT    10
+#define TEST   11
+
+/**
+ * @brief Expose the parser counters of a driver class.
+ */
+template<class T>
+class Probe: public T{
+public:
+  template<class... Args>
+  Probe(Args... args):T(args...){}
+  uint32_t parsed(){ return this->_parser.bytesParsed(); }
+  uint32_t discarded(){ return this->_parser.bytesDiscarded(); }
+};
+
+typedef struct{
+  const char *mode;
+  uint32_t baud;
+  uint32_t frameMs;
+}sBenchCase_t;
+
+template<class S, class F>
+static void measure(const sBenchCase_t &c, const char *op, S &sensor, HostSerial &serial, int iterations, F fn){
+  uint32_t read0 = serial.bytesRead();
+  uint32_t parsed0 = sensor.parsed();
+  uint32_t discarded0 = sensor.discarded();
+  uint64_t v0 = hostNowUs();
+  long rslt = 0;
+  std::chrono::steady_clock::time_point w0 = std::chrono::steady_clock::now();
+  for(int i = 0; i < iterations; i++){
+      rslt = fn();
+  }
+  double wallUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - w0).count();
+  uint32_t consumed = serial.bytesRead() - read0;
+  uint32_t drained = consumed - (sensor.parsed() - parsed0);
+  printf("{\"mode\":\"%s\",\"op\":\"%s\",\"baud\":%lu,\"frame_ms\":%lu,\"iterations\":%d,\"result\":%ld,"
+         "\"virtual_ms\":%.3f,\"wall_us\":%.3f,\"bytes_consumed\":%lu,\"bytes_discarded\":%lu}\n",
+         c.mode, op, (unsigned long)c.baud, (unsigned long)c.frameMs, iterations, rslt,
+         (double)(hostNowUs() - v0) / 1000.0 / iterations, wallUs / iterations,
+         (unsigned long)consumed, (unsigned long)(drained + sensor.discarded() - discarded0));
+}
+
+/**
+ * @brief Run the asynchronous operation which has been started to the end, 1ms per step.
+ */
+template<class S>
+static long runOp(S &sensor, bool started){
+  if(!started) return -1;
+  while(sensor.step() == DFRobot_Nilometer::eOpBusy){
+      delay(1);
+  }
+  return sensor.getOpState();
+}
+
+/**
+ * @brief Call poll every 1ms for 1s.
+ * @return The number of new states.
+ */
+template<class S>
+static long pollFor1s(S &sensor){
+  long states = 0;
+  for(int i = 0; i < 1000; i++){
+      if(sensor.poll()) states++;
+      delay(1);
+  }
+  return states;
+}
+
+static void uartSuite(const sBenchCase_t &c){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  cfg.framePeriodMs = c.frameMs;
+  serial.begin(c.baud);
+  SCW8916B_Emulator emu(&serial, cfg);
+  Probe<DFRobot_SCW8916B_UART> sensor(&serial, EN);
+  emu.attach();
+  delay(1000);
+
+  measure(c, "begin", sensor, serial, 3, [&](){ return (long)sensor.begin(); });
+  measure(c, "detectWater", sensor, serial, 20, [&](){ return (long)sensor.detectWater(); });
+  measure(c, "detectWaterChannels", sensor, serial, 20, [&](){ return (long)sensor.detectWaterChannels(); });
+  measure(c, "poll_1ms_for_1s", sensor, serial, 1, [&](){ return pollFor1s(sensor); });
+  measure(c, "selfCheck", sensor, serial, 3, [&](){ return (long)sensor.selfCheck(); });
+  measure(c, "startSelfCheck", sensor, serial, 3, [&](){ return runOp(sensor, sensor.startSelfCheck()); });
+  measure(c, "setSensitivityLevel", sensor, serial, 3, [&](){ return (long)sensor.setSensitivityLevel(3); });
+  measure(c, "startSetSensitivityLevel", sensor, serial, 3, [&](){ return runOp(sensor, sensor.startSetSensitivityLevel(3)); });
+  measure(c, "calibration", sensor, serial, 3, [&](){ return (long)sensor.calibration(); });
+  measure(c, "startCalibration", sensor, serial, 3, [&](){ return runOp(sensor, sensor.startCalibration()); });
+  measure(c, "checkCalibrationState", sensor, serial, 3, [&](){ return (long)sensor.checkCalibrationState(); });
+  emu.setCalibrated(false);
+  delay(1000);
+  measure(c, "begin_uncalibrated", sensor, serial, 1, [&](){ return (long)sensor.begin(); });
+  emu.detach();
+}
+
+static void ioSuite(const sBenchCase_t &c){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  cfg.out = OUT;
+  cfg.test = TEST;
+  cfg.levelMode = true;
+  serial.begin(c.baud);
+  SCW8916B_Emulator emu(&serial, cfg);
+  Probe<DFRobot_SCW8916B_IO> sensor(OUT, EN, TEST, &serial);
+  emu.attach();
+  delay(1000);
+
+  measure(c, "begin", sensor, serial, 1, [&](){ return (long)sensor.begin(); });
+  measure(c, "detectWater", sensor, serial, 20, [&](){ return (long)sensor.detectWater(); });
+  measure(c, "detectWaterChannels", sensor, serial, 20, [&](){ return (long)sensor.detectWaterChannels(); });
+  measure(c, "poll_1ms_for_1s", sensor, serial, 1, [&](){ return pollFor1s(sensor); });
+  measure(c, "selfCheck", sensor, serial, 3, [&](){ return (long)sensor.selfCheck(); });
+  measure(c, "startSelfCheck", sensor, serial, 3, [&](){ return runOp(sensor, sensor.startSelfCheck()); });
+  measure(c, "calibration", sensor, serial, 3, [&](){ return (long)sensor.calibration(); });
+  measure(c, "startCalibration", sensor, serial, 3, [&](){ return runOp(sensor, sensor.startCalibration()); });
+  measure(c, "checkCalibrationState", sensor, serial, 3, [&](){ return (long)sensor.checkCalibrationState(); });
+  emu.detach();
+}
+
+int main(){
+  static const uint32_t bauds[] = {2400, 9600, 115200};
+  static const uint32_t frames[] = {20, 100, 500};
+  for(uint8_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++){
+      for(uint8_t f = 0; f < sizeof(frames) / sizeof(frames[0]); f++){
+          sBenchCase_t c = {"uart", bauds[b], frames[f]};
+          hostReset();
+          uartSuite(c);
+      }
+      sBenchCase_t c = {"io", bauds[b], 0};
+      hostReset();
+      ioSuite(c);
+  }
+  return 0;
+}
@@ -0,0 +1,552 @@
+/*!
+ * @file host_demo.cpp
+ * @brief Run every public API of the library against the emulated sensor on the virtual clock,
+ * @n in UART detection mode and in level one-to-one detection mode, and print the results and the virtual time.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <stdio.h>
+#include "DFRobot_SCW8916B.h"
+#include "DFRobot_SCW8916B_Fixed.h"
+#include "DFRobot_SCW8916B_Filter.h"
+#include "DFRobot_SCW8916B_IOBank.h"
+#include "DFRobot_SCW8916B_Gauge.h"
+#include "SCW8916B_Emulator.h"
+#include "HostFileStore.h"
+#include "SCW8916B_Replay.h"
+
+#define EN     2
+#define OUT    10
+#define TEST   11
+
+static uint32_t t0;
+
+static void report(const char *name, long rslt){
+  printf("  %-32s -> %-4ld %6lu ms\n", name, rslt, (unsigned long)(millis() - t0));
+  t0 = millis();
+}
+
+#if SCW8916B_ENABLE_STATS
+static void printStats(DFRobot_Nilometer &liquid){
+  static const char *names[eStatOpNum] = {"begin", "detect", "poll", "selfCheck", "calibration", "sensitivity", "checkCalibration",
+                                               "sample"};
+  const sSCW8916BStats_t *stats = liquid.getStats();
+  printf("  stats: bytes %lu, frames %lu, checksum failures %lu, discarded %lu, overflows %lu\n",
+         (unsigned long)stats->bytesParsed, (unsigned long)stats->framesDecoded, (unsigned long)stats->checksumFailures,
+         (unsigned long)stats->bytesDiscarded, (unsigned long)stats->eventsOverflowed);
+  for(uint8_t i = 0; i < eStatOpNum; i++){
+      const sOpStats_t *op = &stats->op[i];
+      if(op->calls == 0) continue;
+      printf("  %-18s calls %-4lu timeouts %-3lu retries %-3lu hist", names[i], (unsigned long)op->calls,
+             (unsigned long)op->timeouts, (unsigned long)op->retries);
+      for(uint8_t b = 0; b < SCW8916B_STATS_BUCKETS; b++){
+          printf(" %u", op->hist[b]);
+      }
+      printf("\n");
+  }
+}
+#endif
+
+static void uartDemo(){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  SCW8916B_Emulator sensor(&serial, cfg);
+  DFRobot_SCW8916B_UART liquid(&serial, EN);
+
+  printf("UART detection mode\n");
+  sensor.attach();
+  delay(1000);
+  t0 = millis();
+  report("begin()", liquid.begin());
+  report("getDiscoveryTime()", liquid.getDiscoveryTime());
+  report("detectWater()", liquid.detectWater());
+  sensor.setWater(0, true);
+  delay(200);
+  t0 = millis();
+  report("detectWater() wet", liquid.detectWater());
+  report("selfCheck()", liquid.selfCheck());
+  report("getSensitivity()", liquid.getSensitivity());
+  report("setSensitivityLevel(5)", liquid.setSensitivityLevel(5));
+  report("selfCheck()", liquid.selfCheck());
+  report("getSensitivity()", liquid.getSensitivity());
+  sensor.setWater(0, false);
+  report("calibration()", liquid.calibration());
+  report("checkCalibrationState()", liquid.checkCalibrationState());
+  liquid.beginSession();
+  report("session selfCheck()", liquid.selfCheck());
+  report("session setSensitivityLevel(2)", liquid.setSensitivityLevel(2));
+  report("session selfCheck()", liquid.selfCheck());
+  report("getSensitivity()", liquid.getSensitivity());
+  liquid.endSession();
+  report("powerCycles", sensor.powerCycles());
+  {
+    uint8_t levels[4] = {1, 2, 6, 4};
+    report("setSensitivityLevels(1,2,6,4)", liquid.setSensitivityLevels(levels));
+    report("getSensitivity(1)", liquid.getSensitivity(1));
+    report("getSensitivity(3)", liquid.getSensitivity(3));
+    report("emulator level of channel 3", sensor.getSensitivity(2));
+  }
+  {
+    DFRobot_SCW8916B_UART::sTuneRslt_t tune;
+    liquid.resetTune(&tune);
+    liquid.beginSession();
+    sensor.setSignal(0, 40);
+    report("tuneSensitivity(empty)", liquid.tuneSensitivity(false, &tune));
+    sensor.setSignal(0, 200);
+    report("tuneSensitivity(full)", liquid.tuneSensitivity(true, &tune));
+    report("applyTune()", liquid.applyTune(&tune));
+    liquid.endSession();
+    printf("  tune: emptyMin %u, fullMax %u, steps %u, readings", tune.emptyMin, tune.fullMax, tune.steps);
+    for(uint8_t i = 0; i < 8; i++) printf(" %x", tune.reading[i]);
+    printf("\n");
+    t0 = millis();
+    sensor.setWater(0, false);
+  }
+  sensor.inject(0x12);
+  delay(10);
+  report("poll()", liquid.poll());
+#if SCW8916B_ENABLE_STATS
+  printStats(liquid);
+#endif
+  sensor.detach();
+}
+
+static void warmBootDemo(){
+  HostSerial serial;
+  HostFileStore store("scw8916b_snapshot.bin");
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  SCW8916B_Emulator sensor(&serial, cfg);
+
+  printf("Warm boot from the snapshot\n");
+  store.erase();
+  sensor.attach();
+  delay(1000);
+  {
+    DFRobot_SCW8916B_UART liquid(&serial, EN);
+    liquid.setStore(&store);
+    t0 = millis();
+    report("cold begin()", liquid.begin());
+    report("cold selfCheck()", liquid.selfCheck());
+  }
+  {
+    DFRobot_SCW8916B_UART liquid(&serial, EN);
+    liquid.setStore(&store);
+    t0 = millis();
+    report("warmBegin()", liquid.warmBegin());
+    report("getSensitivity()", liquid.getSensitivity());
+    report("getCalibrationMode()", liquid.getCalibrationMode());
+  }
+  store.erase();
+  sensor.detach();
+}
+
+static void warmBootIoDemo(){
+  HostSerial serial;
+  HostFileStore store("scw8916b_snapshot.bin");
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  cfg.out = OUT;
+  cfg.test = TEST;
+  cfg.levelMode = true;
+  SCW8916B_Emulator sensor(&serial, cfg);
+
+  printf("Warm boot from the snapshot(level one-to-one detection mode)\n");
+  store.erase();
+  sensor.attach();
+  delay(1000);
+  {
+    DFRobot_SCW8916B_IO liquid(OUT, EN, TEST, &serial);
+    liquid.setStore(&store);
+    t0 = millis();
+    report("cold begin(300)", liquid.begin(300));
+    report("cold selfCheck()", liquid.selfCheck());
+  }
+  {
+    DFRobot_SCW8916B_IO liquid(OUT, EN, TEST, &serial);
+    liquid.setStore(&store);
+    t0 = millis();
+    report("warmBegin()", liquid.warmBegin());
+    report("getCalibrationMode()", liquid.getCalibrationMode());
+  }
+  store.erase();
+  sensor.detach();
+}
+
+static void ioDemo(){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  cfg.out = OUT;
+  cfg.test = TEST;
+  cfg.levelMode = true;
+  SCW8916B_Emulator sensor(&serial, cfg);
+  DFRobot_SCW8916B_IO liquid(OUT, EN, TEST, &serial);
+
+  printf("Level one-to-one detection mode\n");
+  sensor.attach();
+  delay(1000);
+  t0 = millis();
+  report("begin(300)", liquid.begin(300));
+  report("getDiscoveryTime()", liquid.getDiscoveryTime());
+  report("detectWater()", liquid.detectWater());
+  sensor.setWater(0, true);
+  report("detectWater() wet", liquid.detectWater());
+  sensor.setWater(0, false);
+  report("selfCheck()", liquid.selfCheck());
+  report("getCalibrationMode()", liquid.getCalibrationMode());
+  report("calibration()", liquid.calibration());
+  report("checkCalibrationState()", liquid.checkCalibrationState());
+  sensor.detach();
+}
+
+static void fixedDemo(){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  cfg.out = OUT;
+  cfg.test = TEST;
+  SCW8916B_Emulator sensor(&serial, cfg);
+  DFRobot_SCW8916B_Fixed<HostSerial, DFRobot_Nilometer::eUARTDetecteMode, EN> uart(&serial);
+  DFRobot_SCW8916B_Fixed<DFRobot_SCW8916B_NoStream, DFRobot_Nilometer::eLevelDetecteMode, -1, OUT> level;
+
+  printf("Compile-time specialised driver\n");
+  sensor.attach();
+  delay(1000);
+  t0 = millis();
+  report("begin()", uart.begin());
+  sensor.setWater(0, true);
+  delay(200);
+  t0 = millis();
+  report("detectWater() wet", uart.detectWater());
+  report("selfCheck()", uart.selfCheck());
+  report("setSensitivityLevel(4)", uart.setSensitivityLevel(4));
+  report("selfCheck()", uart.selfCheck());
+  report("getSensitivity()", uart.getSensitivity());
+  report("calibration()", uart.calibration());
+  report("level poll()", level.poll());
+  report("level lastState()", level.lastState());
+  sensor.detach();
+}
+
+#if SCW8916B_ENABLE_TRACE
+#define TRACE_RECORDS  2048
+#define TRACE_RESULTS  6
+
+class FilePrint: public Print{
+public:
+  FilePrint(FILE *fp):_fp(fp){}
+  size_t write(uint8_t c){ return (fputc(c, _fp) == EOF) ? 0 : 1; }
+  size_t write(const uint8_t *buffer, size_t size){ return fwrite(buffer, 1, size, _fp); }
+private:
+  FILE *_fp;
+};
+
+/**
+ * @brief The calls which are recorded and replayed, sensor is NULL in the replay.
+ */
+static void traceSession(DFRobot_SCW8916B_UART &liquid, SCW8916B_Emulator *sensor, long *rslt){
+  uint32_t start;
+  rslt[0] = liquid.begin();
+  rslt[1] = liquid.selfCheck();
+  rslt[2] = liquid.detectWaterChannels();
+  if(sensor != NULL) sensor->setWater(0, true);
+  delay(300);
+  rslt[3] = liquid.detectWaterChannels();
+  rslt[4] = liquid.calibration();
+  rslt[5] = 0;
+  start = millis();
+  while(millis() - start < 1000){
+      if(liquid.poll()) rslt[5]++;
+      delay(1);
+  }
+}
+
+static void traceDemo(const char *path){
+  static const char *names[TRACE_RESULTS] = {"begin()", "selfCheck()", "detectWaterChannels()",
+                                             "detectWaterChannels() wet", "calibration()", "poll() states in 1s"};
+  static sTraceRecord_t records[TRACE_RECORDS];
+  DFRobot_SCW8916B_Trace trace(records, TRACE_RECORDS);
+  long recorded[TRACE_RESULTS], replayed[TRACE_RESULTS];
+  SCW8916B_Replay replay;
+  uint64_t us;
+
+  printf("Trace record and replay\n");
+  {
+    HostSerial serial;
+    sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+    cfg.en = EN;
+    SCW8916B_Emulator sensor(&serial, cfg);
+    DFRobot_SCW8916B_UART liquid(&serial, EN);
+    sensor.attach();
+    delay(1000);
+    liquid.setTrace(&trace);
+    traceSession(liquid, &sensor, recorded);
+    liquid.setTrace(NULL);
+    sensor.detach();
+  }
+  if(path != NULL){
+      FILE *fp = fopen(path, "wb");
+      if(fp != NULL){
+          FilePrint out(fp);
+          printf("  dump %u records to %s, %u bytes\n", trace.count(), path, (unsigned)trace.dump(&out));
+          fclose(fp);
+      }
+  }
+  hostReset();
+  replay.load(trace);
+  {
+    DFRobot_SCW8916B_UART liquid(&replay, EN);
+    replay.attach();
+    us = hostNowUs();
+    traceSession(liquid, NULL, replayed);
+    replay.detach();
+  }
+  t0 = millis();
+  for(uint8_t i = 0; i < TRACE_RESULTS; i++){
+      printf("  %-32s -> %-4ld replay %ld\n", names[i], recorded[i], replayed[i]);
+  }
+  printf("  records %u, dropped %lu, outputs %lu, mismatches %lu, replayed %lu ms of virtual time\n",
+         trace.count(), (unsigned long)trace.dropped(), (unsigned long)replay.outputs(),
+         (unsigned long)replay.mismatches(), (unsigned long)((hostNowUs() - us) / 1000));
+}
+#endif
+
+#define BANK_SENSORS   8
+#define BANK_OUT       32   /**<The OUT pins of the bank are 32~39, one port of the shim*/
+
+static void bankDemo(){
+  HostSerial serial;
+  SCW8916B_Emulator *sensor[BANK_SENSORS];
+  DFRobot_SCW8916B_IO *liquid[BANK_SENSORS];
+  DFRobot_SCW8916B_IOBank<BANK_SENSORS> bank;
+  uint32_t reads;
+
+  printf("Batched level sampling\n");
+  for(uint8_t i = 0; i < BANK_SENSORS; i++){
+      sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+      cfg.out = BANK_OUT + i;
+      cfg.levelMode = true;
+      sensor[i] = new SCW8916B_Emulator(&serial, cfg);
+      sensor[i]->attach();
+      liquid[i] = new DFRobot_SCW8916B_IO(BANK_OUT + i);
+      bank.addSensor(liquid[i]);
+  }
+  delay(1000);
+  t0 = millis();
+  report("portCount()", bank.portCount());
+  report("service()", bank.service());
+  sensor[1]->setWater(0, true);
+  sensor[6]->setWater(0, true);
+  reads = hostPortReads();
+  report("service() wet 1, 6", bank.service());
+  report("port reads", hostPortReads() - reads);
+  report("getLevels()", bank.getLevels());
+  report("takeChanged()", bank.takeChanged());
+  report("sensor 6 lastState()", liquid[6]->lastState());
+  report("service() no change", bank.service());
+  for(int i = BANK_SENSORS - 1; i >= 0; i--){
+      sensor[i]->detach();
+      delete sensor[i];
+      delete liquid[i];
+  }
+}
+
+#define GAUGE_PROBES   4
+
+/* Probes at 100, 300, 500 and 700mm on one tank, read by a bank, the tank fills 200mm in 10s. */
+static void gaugeDemo(){
+  HostSerial serial;
+  SCW8916B_Emulator *sensor[GAUGE_PROBES];
+  DFRobot_SCW8916B_IO *liquid[GAUGE_PROBES];
+  DFRobot_SCW8916B_IOBank<GAUGE_PROBES> bank;
+  DFRobot_SCW8916B_Gauge<GAUGE_PROBES> gauge;
+  const uint16_t heights[GAUGE_PROBES] = {100, 300, 500, 700};
+
+  printf("Level gauge\n");
+  for(uint8_t i = 0; i < GAUGE_PROBES; i++){
+      sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+      cfg.out = BANK_OUT + i;
+      cfg.levelMode = true;
+      sensor[i] = new SCW8916B_Emulator(&serial, cfg);
+      sensor[i]->attach();
+      liquid[i] = new DFRobot_SCW8916B_IO(BANK_OUT + i);
+      bank.addSensor(liquid[i]);
+  }
+  delay(1000);
+  t0 = millis();
+  report("begin()", gauge.begin(heights));
+  bank.service();
+  gauge.update(bank.getLevels(), millis());
+  for(uint8_t i = 0; i < 3; i++){
+      delay(10000);
+      sensor[i]->setWater(0, true);
+      if(bank.service()) gauge.update(bank.getLevels(), millis());
+  }
+  report("wetProbes()", gauge.wetProbes());
+  report("level() mm", gauge.level());
+  report("rate() um/s", gauge.rate(millis()));
+  delay(5000);
+  report("estimate() after 5s mm", gauge.estimate(millis()));
+  report("timeToFull() s", gauge.timeToFull(millis()));
+  sensor[1]->setWater(0, false);
+  if(bank.service()) gauge.update(bank.getLevels(), millis());
+  report("probe 2 dry, 3 wet: consistent()", gauge.consistent());
+  report("level() mm", gauge.level());
+  sensor[1]->setWater(0, true);
+  delay(60000);
+  report("rate() after 60s still um/s", gauge.rate(millis()));
+  for(int i = GAUGE_PROBES - 1; i >= 0; i--){
+      sensor[i]->detach();
+      delete sensor[i];
+      delete liquid[i];
+  }
+}
+
+static void filterDemo(){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  SCW8916B_Emulator sensor(&serial, cfg);
+  DFRobot_SCW8916B_UART liquid(&serial);
+  DFRobot_SCW8916B_Filter<8, 6, 6, 500> filter;
+  long raw = 0, filtered = 0;
+  uint8_t last = ERR_CHANNELS_CODE, before;
+
+  printf("Debounce filter\n");
+  sensor.attach();
+  delay(1000);
+  liquid.begin();
+  srand(7);
+  /* 6s dry, 6s wet and 6s dry again, one frame in four near the threshold reads the other state. */
+  for(int i = 0; i < 180; i++){
+      bool water = (i >= 60 && i < 120);
+      sensor.setWater(0, (rand() % 4 == 0) ? !water : water);
+      delay(100);
+      if(!liquid.poll()) continue;
+      if(liquid.lastChannels() != last && last != ERR_CHANNELS_CODE) raw++;
+      last = liquid.lastChannels();
+      before = filter.channels();
+      if(filter.update(last, millis()) && before != ERR_CHANNELS_CODE) filtered++;
+  }
+  t0 = millis();
+  report("raw changes", raw);
+  report("filtered changes", filtered);
+  report("filtered state", filter.channels());
+  sensor.detach();
+}
+
+static void sampleDemo(uint32_t bootMs, int samples){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  cfg.en = EN;
+  cfg.bootMs = bootMs;
+  SCW8916B_Emulator sensor(&serial, cfg);
+  DFRobot_SCW8916B_UART liquid(&serial, EN);
+  const DFRobot_Nilometer::sSampleStats_t *stats = liquid.getSampleStats();
+
+  printf("Duty-cycled sampling(boot %lu ms)\n", (unsigned long)cfg.bootMs);
+  sensor.attach();
+  liquid.begin();
+  t0 = millis();
+  report("selfCheck()(fixed 1.2s cycle)", liquid.selfCheck());
+  for(int i = 0; i < samples; i++){
+      sensor.setWater(0, i % 2 == 1);
+      delay(10000);
+      t0 = millis();
+      report("sample()", liquid.sample() ? liquid.lastChannels() : -1);
+      printf("  %-32s    on %u ms, warm-up %u ms(estimate %u ms)\n", "", stats->lastOnTime, stats->lastWarmup,
+             stats->warmup);
+  }
+  printf("  samples %lu, failures %lu, on %lu ms in total, max %u ms\n", (unsigned long)stats->samples,
+         (unsigned long)stats->failures, (unsigned long)stats->onTime, stats->maxOnTime);
+  sensor.detach();
+}
+
+#if SCW8916B_ENABLE_HEALTH
+static void reportHealth(const char *name, DFRobot_Nilometer &liquid){
+  const sSCW8916BHealth_t *h = liquid.getHealth();
+  printf("  %-32s -> state %u, reasons 0x%02X, validity %u%%, flaps %u, since valid %lu ms\n", name, h->state, h->reasons,
+         h->validity, h->flaps, (unsigned long)h->sinceValid);
+}
+
+/* Poll for ms, as a main loop would. */
+static void pollFor(DFRobot_Nilometer &liquid, uint32_t ms){
+  uint32_t start = millis();
+  while(millis() - start < ms){
+      liquid.poll();
+      delay(10);
+  }
+}
+
+/* A healthy link, a noisy line, a flapping probe and a silent link, seen from poll only. */
+static void healthDemo(){
+  HostSerial serial;
+  sSCW8916BEmulatorConfig_t cfg = SCW8916B_Emulator::defaultConfig();
+  SCW8916B_Emulator sensor(&serial, cfg);
+  DFRobot_SCW8916B_UART liquid(&serial);
+
+  printf("Health monitor\n");
+  sensor.attach();
+  delay(1000);
+  liquid.begin();
+  pollFor(liquid, 2000);
+  reportHealth("2s of frames", liquid);
+  for(int i = 0; i < 200; i++){
+      sensor.inject((uint8_t)(0x31 + i % 7));
+      pollFor(liquid, 10);
+  }
+  reportHealth("2s of a noisy line", liquid);
+  pollFor(liquid, 3000);
+  for(int i = 0; i < 10; i++){
+      sensor.setWater(0, i % 2 == 0);
+      pollFor(liquid, 300);
+  }
+  reportHealth("10 changes in 3s", liquid);
+  pollFor(liquid, 30000);
+  reportHealth("30s later", liquid);
+  sensor.setFramePeriod(0);
+  pollFor(liquid, 4000);
+  reportHealth("no frame for 4s", liquid);
+  sensor.detach();
+}
+#endif
+
+int main(int argc, char **argv){
+  uartDemo();
+  hostReset();
+  warmBootDemo();
+  hostReset();
+  warmBootIoDemo();
+  hostReset();
+  fixedDemo();
+  hostReset();
+  ioDemo();
+  hostReset();
+  bankDemo();
+  hostReset();
+  gaugeDemo();
+  hostReset();
+  filterDemo();
+  hostReset();
+  sampleDemo(350, 5);
+  hostReset();
+  sampleDemo(2600, 3);
+#if SCW8916B_ENABLE_HEALTH
+  hostReset();
+  healthDemo();
+#endif
+#if SCW8916B_ENABLE_TRACE
+  hostReset();
+  traceDemo((argc > 1) ? argv[1] : NULL);
+#else
+  (void)argc;
+  (void)argv;
+#endif
+  return 0;
+}
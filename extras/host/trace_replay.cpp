@@ -0,0 +1,82 @@
+/*!
+ * @file trace_replay.cpp
+ * @brief Re-decode a trace file which is recorded by DFRobot_SCW8916B_Trace through the library at full speed.
+ * @n The virtual clock jumps to every recorded input, poll decodes it, every change of the water state is printed
+ * @n with its recorded time. At the end the number of records, states and the wall time are printed.
+ * @n usage: trace_replay <trace file> [OUT pin(level one-to-one detection mode, default: UART detection mode)] [-q]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <stdio.h>
+#include <time.h>
+#include "DFRobot_SCW8916B.h"
+#include "SCW8916B_Replay.h"
+
+static double wallMs(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+int main(int argc, char **argv){
+  SCW8916B_Replay replay;
+  DFRobot_Nilometer *liquid;
+  DFRobot_SCW8916B_UART *uart = NULL;
+  DFRobot_SCW8916B_IO *io = NULL;
+  int out = -1;
+  bool quiet = false;
+  uint32_t states = 0, changes = 0;
+  uint8_t last = ERR_CHANNELS_CODE;
+  uint64_t start;
+  double t0;
+
+  if(argc < 2){
+      printf("usage: %s <trace file> [OUT pin] [-q]\n", argv[0]);
+      return 2;
+  }
+  for(int i = 2; i < argc; i++){
+      if(strcmp(argv[i], "-q") == 0) quiet = true;
+      else out = atoi(argv[i]);
+  }
+  t0 = wallMs();
+  if(!replay.load(argv[1])){
+      printf("%s: not a trace file\n", argv[1]);
+      return 1;
+  }
+  if(out < 0){
+      uart = new DFRobot_SCW8916B_UART(&replay);
+      liquid = uart;
+  }else{
+      io = new DFRobot_SCW8916B_IO(out);
+      liquid = io;
+  }
+  replay.attach();
+  start = hostNowUs();
+  while(1){
+      uint8_t channels;
+      if(liquid->poll()){
+          states++;
+          channels = liquid->lastChannels();
+          if(channels != last){
+              last = channels;
+              changes++;
+              if(!quiet) printf("%12.3f ms  channels 0x%X\n", (hostNowUs() - start) / 1000.0, channels);
+          }
+      }
+      if(replay.done()) break;
+      hostAdvanceUs(replay.nextEventUs() - hostNowUs());
+  }
+  printf("records: %lu inputs, %lu outputs, %lu dropped\n", (unsigned long)replay.inputs(),
+         (unsigned long)replay.outputs(), (unsigned long)replay.dropped());
+  printf("states: %lu, changes: %lu\n", (unsigned long)states, (unsigned long)changes);
+  printf("recorded %.3f s, replayed in %.3f ms\n", replay.durationUs() / 1000000.0, wallMs() - t0);
+  replay.detach();
+  delete uart;   // ~DFRobot_Nilometer is not virtual, delete the concrete class
+  delete io;
+  return 0;
+}
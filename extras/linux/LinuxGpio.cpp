@@ -0,0 +1,73 @@
+/*!
+ * @file LinuxGpio.cpp
+ * @brief GPIO of a Linux gateway on /sys/class/gpio.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "LinuxGpio.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static bool writeFile(const char *path, const char *val){
+  int fd = ::open(path, O_WRONLY | O_CLOEXEC);
+  if(fd < 0) return false;
+  bool ok = ::write(fd, val, strlen(val)) == (ssize_t)strlen(val);
+  ::close(fd);
+  return ok;
+}
+
+LinuxSysfsGpio::LinuxSysfsGpio(int base, const char *root)
+  :_base(base)
+{
+  snprintf(_root, sizeof(_root), "%s", root);
+  for(uint8_t i = 0; i < HOST_MAX_PINS; i++){
+      _fd[i] = -1;
+  }
+}
+
+LinuxSysfsGpio::~LinuxSysfsGpio(){
+  for(uint8_t i = 0; i < HOST_MAX_PINS; i++){
+      if(_fd[i] >= 0) ::close(_fd[i]);
+  }
+}
+
+int LinuxSysfsGpio::open(uint8_t pin){
+  char path[160], num[16];
+  if(pin >= HOST_MAX_PINS) return -1;
+  if(_fd[pin] >= 0) return _fd[pin];
+  snprintf(num, sizeof(num), "%d", _base + pin);
+  snprintf(path, sizeof(path), "%s/gpio%d/value", _root, _base + pin);
+  if(access(path, F_OK) != 0){
+      char exportPath[160];
+      snprintf(exportPath, sizeof(exportPath), "%s/export", _root);
+      writeFile(exportPath, num);
+  }
+  _fd[pin] = ::open(path, O_RDWR | O_CLOEXEC);
+  return _fd[pin];
+}
+
+void LinuxSysfsGpio::pinMode(uint8_t pin, uint8_t mode){
+  char path[160];
+  if(open(pin) < 0) return;
+  snprintf(path, sizeof(path), "%s/gpio%d/direction", _root, _base + pin);
+  writeFile(path, (mode == OUTPUT) ? "out" : "in");
+}
+
+void LinuxSysfsGpio::digitalWrite(uint8_t pin, uint8_t val){
+  int fd = open(pin);
+  if(fd < 0) return;
+  if(pwrite(fd, val ? "1" : "0", 1, 0) != 1) return;
+}
+
+int LinuxSysfsGpio::digitalRead(uint8_t pin){
+  char c;
+  int fd = open(pin);
+  if(fd < 0 || pread(fd, &c, 1, 0) != 1) return LOW;
+  return (c == '1') ? HIGH : LOW;
+}
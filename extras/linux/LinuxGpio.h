@@ -0,0 +1,44 @@
+/*!
+ * @file LinuxGpio.h
+ * @brief GPIO of a Linux gateway for the EN, OUT and TEST pins of the sensor.
+ * @n The pins are reached through the pluggable HostGpio backend of the Arduino shim(hostSetGpio), so any
+ * @n GPIO library can be used; LinuxSysfsGpio is a dependency-free backend on /sys/class/gpio.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __LINUX_GPIO_H
+#define __LINUX_GPIO_H
+
+#include "Arduino.h"
+
+#define LINUX_GPIO_ROOT   "/sys/class/gpio"
+
+class LinuxSysfsGpio: public HostGpio{
+public:
+/**
+ * @brief LinuxSysfsGpio constructor.
+ * @param base  The GPIO number of pin 0, the library pin n is /sys/class/gpio/gpio(base + n).
+ * @param root  The sysfs GPIO directory, another directory with the same layout stands in for it on a host
+ * @n           without GPIO. The string is copied.
+ */
+  LinuxSysfsGpio(int base = 0, const char *root = LINUX_GPIO_ROOT);
+  ~LinuxSysfsGpio();
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  int  digitalRead(uint8_t pin);
+
+private:
+  int open(uint8_t pin);
+
+  int _base;
+  char _root[128];
+  int _fd[HOST_MAX_PINS];   /**<The opened value files, -1: not exported*/
+};
+
+#endif
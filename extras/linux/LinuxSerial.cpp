@@ -0,0 +1,130 @@
+/*!
+ * @file LinuxSerial.cpp
+ * @brief Stream over a POSIX serial port(termios).
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "LinuxSerial.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <termios.h>
+
+static speed_t baudToSpeed(uint32_t baud){
+  switch(baud){
+      case 1200:   return B1200;
+      case 2400:   return B2400;
+      case 4800:   return B4800;
+      case 19200:  return B19200;
+      case 38400:  return B38400;
+      case 57600:  return B57600;
+      case 115200: return B115200;
+      case 9600:   return B9600;
+      case 230400: return B230400;
+      default:     return B0;
+  }
+}
+
+LinuxSerial::LinuxSerial()
+  :_fd(-1),_pos(0),_len(0),_read(0){}
+
+LinuxSerial::~LinuxSerial(){
+  end();
+}
+
+bool LinuxSerial::begin(const char *path, uint32_t baud){
+  struct termios tio;
+  speed_t speed = baudToSpeed(baud);
+  end();
+  if(speed == B0){
+      errno = EINVAL;
+      return false;
+  }
+  _fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if(_fd < 0) return false;
+  if(tcgetattr(_fd, &tio) != 0){
+      int err = errno;
+      end();
+      errno = err;
+      return false;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  if(cfsetispeed(&tio, speed) != 0 || cfsetospeed(&tio, speed) != 0 || tcsetattr(_fd, TCSANOW, &tio) != 0){
+      int err = errno;
+      end();
+      errno = err;
+      return false;
+  }
+  _pos = 0;
+  _len = 0;
+  return true;
+}
+
+void LinuxSerial::end(){
+  if(_fd < 0) return;
+  ::close(_fd);
+  _fd = -1;
+}
+
+bool LinuxSerial::fill(){
+  ssize_t n;
+  if(_fd < 0) return false;
+  do{
+      n = ::read(_fd, _buf, sizeof(_buf));
+  }while(n < 0 && errno == EINTR);
+  if(n <= 0) return false;
+  _pos = 0;
+  _len = (uint16_t)n;
+  return true;
+}
+
+int LinuxSerial::available(){
+  if(_pos == _len) fill();
+  return _len - _pos;
+}
+
+int LinuxSerial::read(){
+  if(_pos == _len && !fill()) return -1;
+  _read++;
+  return _buf[_pos++];
+}
+
+int LinuxSerial::peek(){
+  if(_pos == _len && !fill()) return -1;
+  return _buf[_pos];
+}
+
+size_t LinuxSerial::write(uint8_t val){
+  return write(&val, 1);
+}
+
+size_t LinuxSerial::write(const uint8_t *buffer, size_t size){
+  size_t done = 0;
+  if(_fd < 0) return 0;
+  while(done < size){
+      ssize_t n = ::write(_fd, buffer + done, size - done);
+      if(n > 0){
+          done += n;
+      }else if(n < 0 && errno == EAGAIN){
+          struct pollfd pfd;
+          int rslt;
+          pfd.fd = _fd;
+          pfd.events = POLLOUT;
+          rslt = ::poll(&pfd, 1, LINUX_SERIAL_TX_TIMEOUT);
+          if(rslt == 0 || (rslt < 0 && errno != EINTR)) break;
+      }else if(n == 0 || errno != EINTR){
+          break;
+      }
+  }
+  return done;
+}
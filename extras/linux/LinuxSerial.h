@@ -0,0 +1,62 @@
+/*!
+ * @file LinuxSerial.h
+ * @brief Stream over a POSIX serial port(termios), so the unchanged library runs on a Linux gateway.
+ * @n The port is opened non-blocking in raw mode, available() reads whatever the kernel has buffered,
+ * @n so poll never blocks and the file descriptor can be watched by epoll.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __LINUX_SERIAL_H
+#define __LINUX_SERIAL_H
+
+#include "Arduino.h"
+
+#define LINUX_SERIAL_RX_SIZE     256    /**<Bytes which are read from the kernel at once*/
+#define LINUX_SERIAL_TX_TIMEOUT  1000   /**<write() gives up when the TX queue stays full this long, unit: ms*/
+
+class LinuxSerial: public Stream{
+public:
+  LinuxSerial();
+  ~LinuxSerial();
+/**
+ * @brief Open the serial port in raw mode, 8N1, non-blocking.
+ * @param path  The device, for example /dev/ttyUSB0, /dev/ttyAMA0 or the slave of a pseudo terminal.
+ * @param baud  The baud rate, 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 or 230400.
+ * @return true: opened, false: fail(errno is set, EINVAL: unsupported baud rate, ENOTTY: not a serial port).
+ */
+  bool begin(const char *path, uint32_t baud = 9600);
+  void end();
+/**
+ * @brief The file descriptor, -1 if the port is not open.
+ */
+  int fd(){ return _fd; }
+
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t val);
+/**
+ * @brief Write the bytes, waiting in poll(2) while the TX queue of the kernel is full.
+ * @return The bytes written, less than size if the queue stays full for LINUX_SERIAL_TX_TIMEOUT ms.
+ */
+  size_t write(const uint8_t *buffer, size_t size);
+  using Print::write;
+
+  uint32_t bytesRead(){ return _read; }
+
+private:
+  bool fill();
+
+  int _fd;
+  uint8_t _buf[LINUX_SERIAL_RX_SIZE];
+  uint16_t _pos;
+  uint16_t _len;
+  uint32_t _read;
+};
+
+#endif
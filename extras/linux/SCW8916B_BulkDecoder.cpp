@@ -0,0 +1,172 @@
+/*!
+ * @file SCW8916B_BulkDecoder.cpp
+ * @brief Bulk decoder of captured UART streams of the sensor.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "SCW8916B_BulkDecoder.h"
+#include "DFRobot_SCW8916B.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BULK_X86        1
+#else
+#define BULK_X86        0
+#endif
+#if BULK_X86 && defined(__SSE2__)
+#define BULK_SSE2       1
+#else
+#define BULK_SSE2       0
+#endif
+
+#define BULK_BLOCK      64   /**<Bytes per iteration of the SIMD kernels, one bit of a 64 bit mask per byte*/
+
+SCW8916B_BulkDecoder::SCW8916B_BulkDecoder(eDecodeImpl_t impl)
+{
+  if(impl == eDecodeAuto) impl = eDecodeAVX2;
+#if BULK_X86
+  __builtin_cpu_init();
+  if(impl == eDecodeAVX2 && !__builtin_cpu_supports("avx2")) impl = eDecodeSSE2;
+#else
+  if(impl == eDecodeAVX2) impl = eDecodeSSE2;
+#endif
+#if !BULK_SSE2
+  if(impl == eDecodeSSE2) impl = eDecodeScalar;
+#endif
+  _impl = impl;
+  reset();
+}
+
+void SCW8916B_BulkDecoder::reset(){
+  _last = 0;
+  _bytes = 0;
+  _frames = 0;
+  _uncalibrated = 0;
+}
+
+const char *SCW8916B_BulkDecoder::implName(){
+  if(_impl == eDecodeAVX2) return "avx2";
+  if(_impl == eDecodeSSE2) return "sse2";
+  return "scalar";
+}
+
+uint8_t SCW8916B_BulkDecoder::state(){
+  if(_last == 0) return ERR_CHANNELS_CODE;
+  if(_last == ERR_CALIBRATION_CODE) return ERR_CALIBRATION_CODE;
+  return _last & 0x0F;
+}
+
+size_t SCW8916B_BulkDecoder::decode(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out){
+  size_t n;
+  if(buf == NULL || len == 0 || out == NULL) return 0;
+  if(_impl == eDecodeAVX2){
+      n = decodeAVX2(buf, len, out);
+  }else if(_impl == eDecodeSSE2){
+      n = decodeSSE2(buf, len, out);
+  }else{
+      n = decodeScalar(buf, len, _bytes, out);
+  }
+  _bytes += len;
+  return n;
+}
+
+/* Walk the bytes for transitions only, the counters are kept by the caller. base: offset of buf[0]. */
+size_t SCW8916B_BulkDecoder::scan(const uint8_t *buf, size_t len, uint64_t base, std::vector<sSCW8916BTransition_t> *out){
+  size_t n = 0;
+  for(size_t i = 0; i < len; i++){
+      uint8_t val = buf[i];
+      if(val == _last) continue;
+      if(DFRobot_SCW8916B_Parser::isDetectFrame(val) || val == ERR_CALIBRATION_CODE){
+          sSCW8916BTransition_t t;
+          t.offset = base + i;
+          t.state = (val == ERR_CALIBRATION_CODE) ? val : (val & 0x0F);
+          out->push_back(t);
+          _last = val;
+          n++;
+      }
+  }
+  return n;
+}
+
+size_t SCW8916B_BulkDecoder::decodeScalar(const uint8_t *buf, size_t len, uint64_t base, std::vector<sSCW8916BTransition_t> *out){
+  for(size_t i = 0; i < len; i++){
+      if(DFRobot_SCW8916B_Parser::isDetectFrame(buf[i])){
+          _frames++;
+      }else if(buf[i] == ERR_CALIBRATION_CODE){
+          _uncalibrated++;
+      }
+  }
+  return scan(buf, len, base, out);
+}
+
+#if BULK_SSE2
+size_t SCW8916B_BulkDecoder::decodeSSE2(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out){
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i marker = _mm_set1_epi8((char)ERR_CALIBRATION_CODE);
+  size_t n = 0, i = 0;
+  for(; i + BULK_BLOCK <= len; i += BULK_BLOCK){
+      __m128i last = _mm_set1_epi8((char)_last);
+      uint64_t frame = 0, uncalib = 0, cand = 0;
+      for(int j = 0; j < BULK_BLOCK / 16; j++){
+          __m128i v = _mm_loadu_si128((const __m128i *)(buf + i + j * 16));
+          /* High nibble is the complement of the low nibble <=> (v ^ v >> 4) & 0x0F == 0x0F, the 16 bit shift
+             moves the high nibble of every byte onto its own low nibble. */
+          __m128i f = _mm_cmpeq_epi8(_mm_and_si128(_mm_xor_si128(v, _mm_srli_epi16(v, 4)), nibble), nibble);
+          __m128i u = _mm_cmpeq_epi8(v, marker);
+          __m128i c = _mm_andnot_si128(_mm_cmpeq_epi8(v, last), _mm_or_si128(f, u));
+          frame |= (uint64_t)(uint16_t)_mm_movemask_epi8(f) << (j * 16);
+          uncalib |= (uint64_t)(uint16_t)_mm_movemask_epi8(u) << (j * 16);
+          cand |= (uint64_t)(uint16_t)_mm_movemask_epi8(c) << (j * 16);
+      }
+      _frames += __builtin_popcountll(frame);
+      _uncalibrated += __builtin_popcountll(uncalib);
+      if(cand){
+          size_t k = __builtin_ctzll(cand);
+          n += scan(buf + i + k, BULK_BLOCK - k, _bytes + i + k, out);
+      }
+  }
+  return n + decodeScalar(buf + i, len - i, _bytes + i, out);
+}
+#else
+size_t SCW8916B_BulkDecoder::decodeSSE2(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out){
+  return decodeScalar(buf, len, _bytes, out);
+}
+#endif
+
+#if BULK_X86
+__attribute__((target("avx2,popcnt")))
+size_t SCW8916B_BulkDecoder::decodeAVX2(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out){
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const __m256i marker = _mm256_set1_epi8((char)ERR_CALIBRATION_CODE);
+  size_t n = 0, i = 0;
+  for(; i + BULK_BLOCK <= len; i += BULK_BLOCK){
+      __m256i last = _mm256_set1_epi8((char)_last);
+      uint64_t frame = 0, uncalib = 0, cand = 0;
+      for(int j = 0; j < BULK_BLOCK / 32; j++){
+          __m256i v = _mm256_loadu_si256((const __m256i *)(buf + i + j * 32));
+          __m256i f = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi16(v, 4)), nibble), nibble);
+          __m256i u = _mm256_cmpeq_epi8(v, marker);
+          __m256i c = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, last), _mm256_or_si256(f, u));
+          frame |= (uint64_t)(uint32_t)_mm256_movemask_epi8(f) << (j * 32);
+          uncalib |= (uint64_t)(uint32_t)_mm256_movemask_epi8(u) << (j * 32);
+          cand |= (uint64_t)(uint32_t)_mm256_movemask_epi8(c) << (j * 32);
+      }
+      _frames += __builtin_popcountll(frame);
+      _uncalibrated += __builtin_popcountll(uncalib);
+      if(cand){
+          size_t k = __builtin_ctzll(cand);
+          n += scan(buf + i + k, BULK_BLOCK - k, _bytes + i + k, out);
+      }
+  }
+  return n + decodeScalar(buf + i, len - i, _bytes + i, out);
+}
+#else
+size_t SCW8916B_BulkDecoder::decodeAVX2(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out){
+  return decodeSSE2(buf, len, out);
+}
+#endif
@@ -0,0 +1,91 @@
+/*!
+ * @file SCW8916B_BulkDecoder.h
+ * @brief Bulk decoder of captured UART streams of the sensor, for re-decoding archived traffic on the gateway.
+ * @n The result is the same as pushing every byte through DFRobot_SCW8916B_Parser(no reply expected) and keeping
+ * @n the last event: a byte is a detection frame(DFRobot_SCW8916B_Parser::isDetectFrame), the uncalibrated marker
+ * @n (ERR_CALIBRATION_CODE) or discarded. Instead of one event per byte only the transitions are written out:
+ * @n an event whose byte differs from the byte of the previous event. Self-check pairs and acks only exist while
+ * @n a command waits for them, so a passive capture holds none, the parser discards or classifies those bytes as well.
+ * @n 32 or 16 bytes are classified at once with AVX2 or SSE2, a block which repeats the last event costs no scalar
+ * @n work, so the throughput of a steady stream is bounded by memory bandwidth. Other CPUs use the scalar loop.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __SCW8916B_BULK_DECODER_H
+#define __SCW8916B_BULK_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @brief One transition of the decoded stream, 8 bytes.
+ */
+typedef struct{
+  uint64_t offset: 56;  /**<Offset of the byte in the stream since the last reset*/
+  uint64_t state: 8;    /**<Channel mask 0~15(bit0~bit3: channel 1~4) or ERR_CALIBRATION_CODE(0xAA): uncalibrated*/
+}sSCW8916BTransition_t;
+
+class SCW8916B_BulkDecoder{
+public:
+typedef enum{
+  eDecodeAuto = 0,  /**<The widest kernel which the CPU supports*/
+  eDecodeScalar,
+  eDecodeSSE2,
+  eDecodeAVX2
+}eDecodeImpl_t;
+
+/**
+ * @brief SCW8916B_BulkDecoder constructor.
+ * @param impl  The kernel, a kernel which the CPU does not support falls back to the next narrower one.
+ */
+  SCW8916B_BulkDecoder(eDecodeImpl_t impl = eDecodeAuto);
+/**
+ * @brief Start a new stream: offset, last event and counters are cleared.
+ */
+  void reset();
+/**
+ * @brief Decode the next part of the stream, a stream may be split at any byte into any number of calls.
+ * @param buf  The bytes.
+ * @param len  The number of bytes.
+ * @param out  The transitions are appended to it.
+ * @return The number of transitions appended.
+ */
+  size_t decode(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out);
+/**
+ * @brief The last event, the same encoding as sSCW8916BTransition_t::state, 0xFF(ERR_CHANNELS_CODE): no event yet.
+ */
+  uint8_t state();
+/**
+ * @brief The kernel in use, "scalar", "sse2" or "avx2".
+ */
+  eDecodeImpl_t impl(){ return _impl; }
+  const char *implName();
+/**
+ * @brief Counters since reset, the same as bytesParsed, framesDecoded and bytesDiscarded(= checksumFailures, a
+ * @n capture has no drained bytes) of DFRobot_SCW8916B_Parser.
+ */
+  uint64_t bytesParsed(){ return _bytes; }
+  uint64_t framesDecoded(){ return _frames; }
+  uint64_t bytesDiscarded(){ return _bytes - _frames - _uncalibrated; }
+  uint64_t uncalibrated(){ return _uncalibrated; }
+
+private:
+  size_t scan(const uint8_t *buf, size_t len, uint64_t base, std::vector<sSCW8916BTransition_t> *out);
+  size_t decodeScalar(const uint8_t *buf, size_t len, uint64_t base, std::vector<sSCW8916BTransition_t> *out);
+  size_t decodeSSE2(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out);
+  size_t decodeAVX2(const uint8_t *buf, size_t len, std::vector<sSCW8916BTransition_t> *out);
+
+  eDecodeImpl_t _impl;
+  uint8_t _last;          /**<Byte of the last event, 0 before the first one(0 is neither frame nor marker)*/
+  uint64_t _bytes;
+  uint64_t _frames;
+  uint64_t _uncalibrated;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*!
+ * @file SCW8916B_Gateway.cpp
+ * @brief epoll event loop which services many UART sensors from one Linux process.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include "SCW8916B_Gateway.h"
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+
+SCW8916B_Gateway::SCW8916B_Gateway()
+  :_cb(NULL),_ctx(NULL),_wakeups(0),_polls(0),_changes(0)
+{
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+}
+
+SCW8916B_Gateway::~SCW8916B_Gateway(){
+  if(_epfd >= 0) close(_epfd);
+}
+
+int SCW8916B_Gateway::addSensor(LinuxSerial *serial, DFRobot_SCW8916B_UART *sensor){
+  struct epoll_event ev;
+  sEntry_t entry;
+  if(_epfd < 0 || serial == NULL || sensor == NULL || serial->fd() < 0) return -1;
+  ev.events = EPOLLIN;
+  ev.data.u32 = (uint32_t)_entry.size();
+  if(epoll_ctl(_epfd, EPOLL_CTL_ADD, serial->fd(), &ev) != 0) return -1;
+  entry.serial = serial;
+  entry.sensor = sensor;
+  entry.channels = ERR_CHANNELS_CODE;
+  _entry.push_back(entry);
+  return (int)_entry.size() - 1;
+}
+
+int SCW8916B_Gateway::service(int timeout){
+  struct epoll_event ev[GATEWAY_MAX_EVENTS];
+  int changes = 0;
+  int n = epoll_wait(_epfd, ev, GATEWAY_MAX_EVENTS, timeout);
+  if(n < 0) return (errno == EINTR) ? 0 : -1;
+  if(n > 0) _wakeups++;
+  for(int i = 0; i < n; i++){
+      uint32_t index = ev[i].data.u32;
+      if(index >= _entry.size()) continue;
+      sEntry_t *e = &_entry[index];
+      _polls++;
+      e->sensor->poll();
+      if(!e->sensor->available()) continue;
+      uint8_t channels = e->sensor->lastChannels();
+      if(channels == e->channels) continue;
+      e->channels = channels;
+      changes++;
+      if(_cb != NULL) _cb((uint16_t)index, channels, _ctx);
+  }
+  _changes += changes;
+  return changes;
+}
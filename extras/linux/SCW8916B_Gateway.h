@@ -0,0 +1,82 @@
+/*!
+ * @file SCW8916B_Gateway.h
+ * @brief epoll event loop which services many UART sensors from one Linux process.
+ * @n Every sensor is a DFRobot_SCW8916B_UART on its own LinuxSerial, the gateway waits on all file descriptors
+ * @n at once and only polls the sensors whose port has data, so the cost follows the traffic and not the number
+ * @n of sensors. Frames are decoded by DFRobot_Nilometer::poll, the same code which runs on the MCU.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __SCW8916B_GATEWAY_H
+#define __SCW8916B_GATEWAY_H
+
+#include "DFRobot_SCW8916B.h"
+#include "LinuxSerial.h"
+#include <vector>
+
+#define GATEWAY_MAX_EVENTS   64   /**<epoll events which are taken by one epoll_wait*/
+
+/**
+ * @brief Callback of a state change.
+ * @param index     The index of the sensor which is returned by addSensor.
+ * @param channels  The new water state mask, bit0~bit3: channel 1~4.
+ * @param ctx       The context which is passed to setCallback.
+ */
+typedef void (*SCW8916BGatewayCallback_t)(uint16_t index, uint8_t channels, void *ctx);
+
+class SCW8916B_Gateway{
+public:
+  SCW8916B_Gateway();
+  ~SCW8916B_Gateway();
+/**
+ * @brief Add a sensor, the serial port must be open.
+ * @param serial  The serial port of the sensor.
+ * @param sensor  The sensor object which reads from serial.
+ * @return The index of the sensor, -1: the port is not open or epoll fail.
+ */
+  int addSensor(LinuxSerial *serial, DFRobot_SCW8916B_UART *sensor);
+  uint16_t count(){ return (uint16_t)_entry.size(); }
+/**
+ * @brief Set the callback which is called on every state change, NULL to disable it.
+ */
+  void setCallback(SCW8916BGatewayCallback_t cb, void *ctx = NULL){ _cb = cb; _ctx = ctx; }
+/**
+ * @brief Wait until at least one port has data or timeout, then poll the sensors whose port has data.
+ * @param timeout  The max wait, unit: ms, 0: do not wait, -1: wait forever.
+ * @return The number of state changes, -1: epoll fail.
+ */
+  int service(int timeout);
+/**
+ * @brief Get the water state mask of a sensor from the state table.
+ * @return water state mask, bit0~bit3: channel 1~4, 0xFF(ERR_CHANNELS_CODE): no valid state yet.
+ */
+  uint8_t getChannels(uint16_t index){ return (index < _entry.size()) ? _entry[index].channels : ERR_CHANNELS_CODE; }
+/**
+ * @brief Counters: epoll wakeups, sensor polls and state changes.
+ */
+  uint32_t wakeups(){ return _wakeups; }
+  uint32_t polls(){ return _polls; }
+  uint32_t changes(){ return _changes; }
+
+private:
+  typedef struct{
+    LinuxSerial *serial;
+    DFRobot_SCW8916B_UART *sensor;
+    uint8_t channels;
+  }sEntry_t;
+
+  int _epfd;
+  std::vector<sEntry_t> _entry;
+  SCW8916BGatewayCallback_t _cb;
+  void *_ctx;
+  uint32_t _wakeups;
+  uint32_t _polls;
+  uint32_t _changes;
+};
+
+#endif
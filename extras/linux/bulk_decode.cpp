@@ -0,0 +1,165 @@
+/*!
+ * @file bulk_decode.cpp
+ * @brief Decode a captured UART stream with SCW8916B_BulkDecoder, or check every kernel against the parser.
+ * @n With a file: the transitions(byte offset and state) and the counters are printed with the throughput.
+ * @n Without a file: a synthetic capture(steady frames, state changes, uncalibrated markers, line noise) is decoded
+ * @n byte by byte by DFRobot_SCW8916B_Parser and by every kernel in random sized chunks, the transitions and
+ * @n counters must be identical, then the throughput of every kernel is printed.
+ * @n usage: bulk_decode [capture file] [-q]
+ * @n        bulk_decode [MiB of the synthetic capture(default 256)]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "DFRobot_SCW8916B.h"
+#include "SCW8916B_BulkDecoder.h"
+
+#define CHUNK_SIZE   (1 << 20)
+
+static double wallS(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int decodeFile(const char *path, bool quiet){
+  FILE *fp = fopen(path, "rb");
+  std::vector<uint8_t> buf(CHUNK_SIZE);
+  std::vector<sSCW8916BTransition_t> out;
+  SCW8916B_BulkDecoder decoder;
+  double t0, t;
+  size_t len;
+  if(fp == NULL){
+      printf("%s: can not open\n", path);
+      return 1;
+  }
+  t0 = wallS();
+  while((len = fread(&buf[0], 1, buf.size(), fp)) > 0){
+      decoder.decode(&buf[0], len, &out);
+  }
+  t = wallS() - t0;
+  fclose(fp);
+  if(!quiet){
+      for(size_t i = 0; i < out.size(); i++){
+          if(out[i].state == ERR_CALIBRATION_CODE){
+              printf("%12llu  uncalibrated\n", (unsigned long long)out[i].offset);
+          }else{
+              printf("%12llu  channels 0x%X\n", (unsigned long long)out[i].offset, (unsigned)out[i].state);
+          }
+      }
+  }
+  printf("kernel %s: %llu bytes, %llu frames, %llu uncalibrated, %llu discarded, %zu transitions\n", decoder.implName(),
+         (unsigned long long)decoder.bytesParsed(), (unsigned long long)decoder.framesDecoded(),
+         (unsigned long long)decoder.uncalibrated(), (unsigned long long)decoder.bytesDiscarded(), out.size());
+  printf("%.3f s, %.2f GB/s(including file read)\n", t, decoder.bytesParsed() / t / 1e9);
+  return 0;
+}
+
+/* A capture of a sensor which sends its state continuously: runs of one frame, rare state changes,
+   bursts of the uncalibrated marker and single noise bytes. */
+static void synth(std::vector<uint8_t> *buf, size_t size){
+  uint8_t frame = 0xF0;
+  buf->resize(size);
+  srand(1);
+  for(size_t i = 0; i < size; i++){
+      int r = rand();
+      if(r % 4096 == 0){
+          uint8_t mask = rand() & 0x0F;
+          frame = (uint8_t)((~mask << 4) | mask);
+      }else if(r % 65536 == 1){
+          frame = ERR_CALIBRATION_CODE;
+      }
+      (*buf)[i] = (r % 1024 == 2) ? (uint8_t)(rand() >> 3) : frame;
+  }
+}
+
+static void reference(const std::vector<uint8_t> &buf, std::vector<sSCW8916BTransition_t> *out,
+                      DFRobot_SCW8916B_Parser *parser){
+  uint8_t last = ERR_CHANNELS_CODE;
+  for(size_t i = 0; i < buf.size(); i++){
+      uint8_t type = parser->push(buf[i]);
+      uint8_t state;
+      if(type == DFRobot_SCW8916B_Parser::eEventDetect){
+          state = buf[i] & 0x0F;
+      }else if(type == DFRobot_SCW8916B_Parser::eEventUncalibrated){
+          state = ERR_CALIBRATION_CODE;
+      }else{
+          continue;
+      }
+      if(state != last){
+          sSCW8916BTransition_t t;
+          t.offset = i;
+          t.state = state;
+          out->push_back(t);
+          last = state;
+      }
+  }
+}
+
+static bool same(const std::vector<sSCW8916BTransition_t> &a, const std::vector<sSCW8916BTransition_t> &b){
+  if(a.size() != b.size()) return false;
+  for(size_t i = 0; i < a.size(); i++){
+      if(a[i].offset != b[i].offset || a[i].state != b[i].state) return false;
+  }
+  return true;
+}
+
+static int check(size_t mib){
+  const SCW8916B_BulkDecoder::eDecodeImpl_t impl[] = {SCW8916B_BulkDecoder::eDecodeScalar,
+                                                      SCW8916B_BulkDecoder::eDecodeSSE2,
+                                                      SCW8916B_BulkDecoder::eDecodeAVX2};
+  std::vector<uint8_t> buf;
+  std::vector<sSCW8916BTransition_t> ref;
+  DFRobot_SCW8916B_Parser parser;
+  int fail = 0;
+  double t0, t;
+
+  synth(&buf, mib << 20);
+  t0 = wallS();
+  reference(buf, &ref, &parser);
+  t = wallS() - t0;
+  printf("parser    %6.2f GB/s  %zu transitions, %lu frames, %lu discarded\n", buf.size() / t / 1e9, ref.size(),
+         (unsigned long)parser.framesDecoded(), (unsigned long)parser.bytesDiscarded());
+  for(size_t k = 0; k < sizeof(impl) / sizeof(impl[0]); k++){
+      SCW8916B_BulkDecoder decoder(impl[k]);
+      std::vector<sSCW8916BTransition_t> out;
+      bool ok;
+      if(decoder.impl() != impl[k]) continue;
+      /* Random chunks: a stream split anywhere gives the same result. */
+      for(size_t pos = 0; pos < buf.size(); ){
+          size_t len = 1 + rand() % 4096;
+          if(len > buf.size() - pos) len = buf.size() - pos;
+          decoder.decode(&buf[pos], len, &out);
+          pos += len;
+      }
+      ok = same(ref, out) && decoder.framesDecoded() == parser.framesDecoded() &&
+           decoder.bytesDiscarded() == parser.bytesDiscarded();
+      out.clear();
+      decoder.reset();
+      t0 = wallS();
+      decoder.decode(&buf[0], buf.size(), &out);
+      t = wallS() - t0;
+      ok = ok && same(ref, out);
+      printf("%-9s %6.2f GB/s  %s\n", decoder.implName(), buf.size() / t / 1e9, ok ? "match" : "MISMATCH");
+      if(!ok) fail = 1;
+  }
+  return fail;
+}
+
+int main(int argc, char **argv){
+  bool quiet = false;
+  const char *path = NULL;
+  for(int i = 1; i < argc; i++){
+      if(strcmp(argv[i], "-q") == 0) quiet = true;
+      else path = argv[i];
+  }
+  if(path != NULL && atoi(path) <= 0) return decodeFile(path, quiet);
+  return check((path != NULL) ? atoi(path) : 256);
+}
@@ -0,0 +1,118 @@
+/*!
+ * @file gateway_demo.cpp
+ * @brief Service many emulated UART sensors from one process with the epoll gateway, without hardware.
+ * @n Every sensor is a pseudo-terminal pair: the gateway opens the slave side with LinuxSerial, the demo writes
+ * @n detection frames to the master side every 100ms and changes the water state of random sensors.
+ * @n At the end the state table of the gateway is compared with the states which were sent.
+ * @n usage: gateway_demo [sensors(default 200)] [seconds(default 3)]
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <vector>
+#include "SCW8916B_Gateway.h"
+
+#define FRAME_PERIOD_MS   100
+
+typedef struct{
+  int master;
+  LinuxSerial *serial;
+  DFRobot_SCW8916B_UART *sensor;
+  uint8_t channels;
+}sPty_t;
+
+static int openPty(char *slave, size_t len){
+  int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if(fd < 0) return -1;
+  if(grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, slave, len) != 0){
+      close(fd);
+      return -1;
+  }
+  return fd;
+}
+
+static void onChange(uint16_t index, uint8_t channels, void *ctx){
+  (void)index;
+  (void)channels;
+  (*(uint32_t *)ctx)++;
+}
+
+int main(int argc, char **argv){
+  int count = (argc > 1) ? atoi(argv[1]) : 200;
+  int seconds = (argc > 2) ? atoi(argv[2]) : 3;
+  std::vector<sPty_t> pty;
+  SCW8916B_Gateway gateway;
+  uint32_t callbacks = 0, frames = 0, flips = 0, mismatches = 0;
+  struct timespec cpu0, cpu1;
+
+  hostUseRealClock(true);
+  srand(1);
+  for(int i = 0; i < count; i++){
+      char slave[64];
+      sPty_t p;
+      p.master = openPty(slave, sizeof(slave));
+      if(p.master < 0){
+          perror("posix_openpt");
+          return 1;
+      }
+      p.serial = new LinuxSerial();
+      if(!p.serial->begin(slave, 9600)){
+          perror(slave);
+          return 1;
+      }
+      p.sensor = new DFRobot_SCW8916B_UART(p.serial);
+      p.channels = 0;
+      if(gateway.addSensor(p.serial, p.sensor) < 0){
+          perror("epoll_ctl");
+          return 1;
+      }
+      pty.push_back(p);
+  }
+  gateway.setCallback(onChange, &callbacks);
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu0);
+  uint32_t end = millis() + seconds * 1000;
+  uint32_t next = millis();
+  while((int32_t)(millis() - end) < 0){
+      if((int32_t)(millis() - next) >= 0){
+          next += FRAME_PERIOD_MS;
+          for(size_t i = 0; i < pty.size(); i++){
+              if(rand() % 20 == 0){
+                  pty[i].channels ^= WATER_CHANNEL_1;
+                  flips++;
+              }
+              uint8_t frame = (uint8_t)((~pty[i].channels << 4) | pty[i].channels);
+              if(write(pty[i].master, &frame, 1) == 1) frames++;
+          }
+      }
+      int32_t wait = (int32_t)(next - millis());
+      gateway.service(wait > 0 ? wait : 0);
+  }
+  while(gateway.service(50) > 0 || gateway.service(50) > 0){
+  }
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu1);
+
+  for(size_t i = 0; i < pty.size(); i++){
+      if(gateway.getChannels(i) != pty[i].channels) mismatches++;
+  }
+  double cpu = (cpu1.tv_sec - cpu0.tv_sec) + (cpu1.tv_nsec - cpu0.tv_nsec) / 1e9;
+  printf("{\"sensors\":%d,\"seconds\":%d,\"frames\":%lu,\"flips\":%lu,\"changes\":%lu,\"callbacks\":%lu,"
+         "\"wakeups\":%lu,\"polls\":%lu,\"cpu_s\":%.3f,\"mismatches\":%lu}\n",
+         count, seconds, (unsigned long)frames, (unsigned long)flips, (unsigned long)gateway.changes(),
+         (unsigned long)callbacks, (unsigned long)gateway.wakeups(), (unsigned long)gateway.polls(), cpu,
+         (unsigned long)mismatches);
+  for(size_t i = 0; i < pty.size(); i++){
+      delete pty[i].sensor;
+      delete pty[i].serial;
+      close(pty[i].master);
+  }
+  return mismatches ? 1 : 0;
+}
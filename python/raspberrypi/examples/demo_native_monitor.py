@@ -0,0 +1,67 @@
+from __future__ import print_function
+# -*- coding:utf-8 -*-
+
+'''
+  # demo_native_monitor.py
+  #
+  # This demo monitors several Non-contact liquid level sensors in UART detection mode from one thread with the
+  # scw8916b extension(the C++ library of this repository, see native/setup.py), and calibrates a sensor without
+  # blocking the monitor.
+  # Experimental phenomena: Every change of the water state of a sensor prints the port and the state of the 4 channels.
+  # Build the extension first:
+  #   cd python/raspberrypi/native && python3 setup.py build_ext --inplace
+  # usage: python3 demo_native_monitor.py /dev/ttyAMA0 [/dev/ttyUSB0 ...]
+  #
+  # @n connected table in eUART_DETECT_MODE(every sensor)
+  # -----------------------------------------------------------------------------
+  # sensor pin |             MCU                |         raspberry pi          |
+  #     TEST   |    Not connected, floating     |  Not connected, floating(-1)  |
+  #     OUT    |    Not connected, floating     |  Not connected, floating(-1)  |
+  #     EN     |    Not connected, floating(-1) |  Not connected, floating(-1)  |
+  #     VCC    |            3.3V/5V             |            5V/3V3             |
+  #     GND    |              GND               |             GND               |
+  #     RX     |              TX                |          TX of the port       |
+  #     TX     |              RX                |          RX of the port       |
+  # -----------------------------------------------------------------------------
+  #
+  # Copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  # licence     The MIT License (MIT)
+  # author [Arya](xue.peng@dfrobot.com)
+  # version  V1.0
+  # date  2021-05-16
+  # get from https://www.dfrobot.com
+  # url from https://github.com/DFRobot/DFRobot_SCW8916B
+'''
+
+import sys
+import os
+
+sys.path.append(os.path.join(os.path.dirname(os.path.dirname(os.path.realpath(__file__))), "native"))
+import scw8916b
+
+ports = sys.argv[1:] if len(sys.argv) > 1 else ["/dev/ttyAMA0"]
+sensors = [scw8916b.UART(port) for port in ports]
+#sensors = [scw8916b.UART("/dev/ttyAMA0", en = 27)]   # 27 is the io pin of raspberry pi in BCM mode which is connected to the EN pin, needed by calibration.
+
+if __name__ == "__main__":
+  names = dict((id(s), p) for s, p in zip(sensors, ports))
+  calibrating = []
+  for s in sensors:
+    if s.begin() == scw8916b.ERR_CALIBRATION_CODE:
+      print("%s has never been calibrated."%names[id(s)])
+      if s.start_calibration():  #Needs the EN pin, step() is called in the loop below
+        calibrating.append(s)
+        print("%s calibration started."%names[id(s)])
+
+  while True:
+    for s, channels in scw8916b.wait_any(sensors, timeout = 0.1):  #Blocks in poll(2) without the GIL
+      print("%s: channel1~4 = %d %d %d %d"%(names[id(s)], channels & 1, (channels >> 1) & 1, (channels >> 2) & 1, (channels >> 3) & 1))
+    for s in calibrating[:]:
+      state = s.step()                   #Never blocks
+      if state == scw8916b.OP_BUSY:
+        continue
+      calibrating.remove(s)
+      if state == scw8916b.OP_DONE:
+        print("%s calibration sucess, check: %d"%(names[id(s)], s.check_calibration_state()))
+      else:
+        print("%s calibration failed."%names[id(s)])
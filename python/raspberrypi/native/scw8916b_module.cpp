@@ -0,0 +1,649 @@
+/*!
+ * @file scw8916b_module.cpp
+ * @brief CPython extension of the Non-contact liquid level sensor on top of the C++ library(module scw8916b).
+ * @n The unchanged library runs on the Arduino shim of extras/host with the real clock, the serial port is a
+ * @n LinuxSerial(termios) and the EN, OUT and TEST pins use the sysfs GPIO backend of extras/linux.
+ * @n Every call into the library releases the GIL, a mutex of the sensor object serialises the calls of the
+ * @n threads which share one sensor. wait() and wait_any() block in poll(2) on the serial ports instead of
+ * @n sleeping, so many sensors can be monitored from one thread, and handle Ctrl-C at least every WAIT_SLICE ms.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <poll.h>
+#include <errno.h>
+#include <limits.h>
+#include <mutex>
+#include <vector>
+#include "LinuxSerial.h"
+#include "LinuxGpio.h"
+#include "DFRobot_SCW8916B.h"
+
+#define IO_WAIT_INTERVAL   10    /**<Sample interval of the OUT pin in wait(), unit: ms*/
+#define WAIT_SLICE         1000  /**<wait() handles the signals(Ctrl-C) at least this often, unit: ms*/
+
+typedef struct{
+  PyObject_HEAD
+  LinuxSerial *serial;
+  DFRobot_Nilometer *sensor;   /**<uart or io, every call goes through it*/
+  DFRobot_SCW8916B_UART *uart;  /**<The concrete sensor which is deleted, ~DFRobot_Nilometer is not virtual*/
+  DFRobot_SCW8916B_IO *io;
+  std::mutex *lock;
+  uint8_t reported;     /**<The channels which are returned by the last wait, ERR_CHANNELS_CODE: none*/
+}sSensorObject_t;
+
+static LinuxSysfsGpio *_gpio = NULL;
+static int _gpioBase = 0;
+static char _gpioRoot[128] = LINUX_GPIO_ROOT;
+
+/* Run a library call without the GIL, with the lock of the sensor held. */
+#define SENSOR_CALL(self, expr) do{ \
+      Py_BEGIN_ALLOW_THREADS \
+      (self)->lock->lock(); \
+      expr; \
+      (self)->lock->unlock(); \
+      Py_END_ALLOW_THREADS \
+  }while(0)
+
+static void useGpio(){
+  if(_gpio != NULL) return;
+  _gpio = new LinuxSysfsGpio(_gpioBase, _gpioRoot);
+  hostSetGpio(_gpio);
+}
+
+static bool ready(sSensorObject_t *self){
+  if(self->sensor == NULL){
+      PyErr_SetString(PyExc_RuntimeError, "the sensor is not initialised");
+      return false;
+  }
+  return true;
+}
+
+static bool openSerial(sSensorObject_t *self, const char *port, unsigned long baud){
+  self->serial = new LinuxSerial();
+  if(!self->serial->begin(port, baud)){
+      PyErr_SetFromErrnoWithFilename(PyExc_OSError, port);
+      delete self->serial;
+      self->serial = NULL;
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Poll the sensor once, return the channels if they differ from the channels which were reported last time,
+ * otherwise ERR_CHANNELS_CODE. The lock of the sensor must be held.
+ */
+static uint8_t takeChange(sSensorObject_t *self){
+  uint8_t channels;
+  self->sensor->poll();
+  if(!self->sensor->available()) return ERR_CHANNELS_CODE;
+  channels = self->sensor->lastChannels();
+  if(channels == self->reported) return ERR_CHANNELS_CODE;
+  self->reported = channels;
+  return channels;
+}
+
+/*
+ * The file descriptor which carries the water states, -1 in level one-to-one detection mode: the serial port
+ * only carries the self-check reply there, the OUT pin is sampled instead.
+ */
+static int sensorFd(sSensorObject_t *self){
+  if(self->serial == NULL || self->sensor->getOutPin() >= 0) return -1;
+  return self->serial->fd();
+}
+
+/*
+ * Wait for a state change of any of the sensors, without the GIL. A negative timeout waits forever.
+ * The sensors without a file descriptor(level one-to-one detection mode) are sampled every IO_WAIT_INTERVAL ms.
+ * @return The number of changed sensors, 0: timeout or interrupted by a signal, -1: poll(2) failed(errno is set).
+ */
+static int waitChanges(std::vector<sSensorObject_t *> &sensors, std::vector<uint8_t> &changes, int timeout){
+  std::vector<struct pollfd> fds(sensors.size());
+  uint32_t start = millis();
+  bool sampled = false;
+  int found = 0;
+  changes.assign(sensors.size(), ERR_CHANNELS_CODE);
+  for(size_t i = 0; i < sensors.size(); i++){
+      fds[i].fd = sensorFd(sensors[i]);
+      fds[i].events = POLLIN;
+      if(fds[i].fd < 0) sampled = true;
+  }
+  while(1){
+      int wait, rslt;
+      for(size_t i = 0; i < sensors.size(); i++){
+          sensors[i]->lock->lock();
+          changes[i] = takeChange(sensors[i]);
+          sensors[i]->lock->unlock();
+          if(changes[i] != ERR_CHANNELS_CODE) found++;
+      }
+      if(found) return found;
+      if(timeout >= 0){
+          uint32_t elapsed = millis() - start;
+          if(elapsed >= (uint32_t)timeout) return 0;
+          wait = timeout - elapsed;
+      }else{
+          wait = -1;
+      }
+      if(sampled && (wait < 0 || wait > IO_WAIT_INTERVAL)) wait = IO_WAIT_INTERVAL;
+      rslt = ::poll(fds.data(), fds.size(), wait);
+      if(rslt < 0) return (errno == EINTR) ? 0 : -1;
+  }
+}
+
+/*
+ * waitChanges() with the GIL held by the caller: the GIL is released for slices of at most WAIT_SLICE ms,
+ * the signals are handled between the slices, so Ctrl-C interrupts a long wait.
+ * @return The number of changed sensors, 0: timeout, -1: error(the Python exception is set).
+ */
+static int waitInterruptible(std::vector<sSensorObject_t *> &sensors, std::vector<uint8_t> &changes, int timeout){
+  uint32_t start = millis();
+  int rslt;
+  while(1){
+      int wait = WAIT_SLICE;
+      if(timeout >= 0){
+          uint32_t elapsed = millis() - start;
+          if(elapsed >= (uint32_t)timeout) wait = 0;
+          else if((uint32_t)timeout - elapsed < WAIT_SLICE) wait = timeout - elapsed;
+      }
+      Py_BEGIN_ALLOW_THREADS
+      rslt = waitChanges(sensors, changes, wait);
+      Py_END_ALLOW_THREADS
+      if(rslt < 0){
+          PyErr_SetFromErrno(PyExc_OSError);
+          return -1;
+      }
+      if(rslt > 0) return rslt;
+      if(PyErr_CheckSignals() < 0) return -1;
+      if(timeout >= 0 && millis() - start >= (uint32_t)timeout) return 0;
+  }
+}
+
+static int timeoutMs(PyObject *timeout, int *ms){
+  double t;
+  if(timeout == NULL || timeout == Py_None){
+      *ms = -1;
+      return 0;
+  }
+  t = PyFloat_AsDouble(timeout);
+  if(t == -1.0 && PyErr_Occurred()) return -1;
+  if(t <= 0){
+      *ms = 0;
+  }else if(!(t < INT_MAX / 1000.0)){   // also NaN and inf
+      *ms = INT_MAX;
+  }else{
+      *ms = (int)(t * 1000);
+  }
+  return 0;
+}
+
+static void Sensor_dealloc(sSensorObject_t *self){
+  delete self->uart;
+  delete self->io;
+  delete self->serial;
+  delete self->lock;
+  Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *Sensor_new(PyTypeObject *type, PyObject *args, PyObject *kwds){
+  sSensorObject_t *self = (sSensorObject_t *)type->tp_alloc(type, 0);
+  (void)args;
+  (void)kwds;
+  if(self == NULL) return NULL;
+  self->serial = NULL;
+  self->sensor = NULL;
+  self->uart = NULL;
+  self->io = NULL;
+  self->lock = new std::mutex();
+  self->reported = ERR_CHANNELS_CODE;
+  return (PyObject *)self;
+}
+
+static int UART_init(sSensorObject_t *self, PyObject *args, PyObject *kwds){
+  static const char *kwlist[] = {"port", "baud", "en", NULL};
+  const char *port = "/dev/ttyAMA0";
+  unsigned long baud = 9600;
+  int en = -1;
+  if(!PyArg_ParseTupleAndKeywords(args, kwds, "|ski", (char **)kwlist, &port, &baud, &en)) return -1;
+  if(self->sensor != NULL){
+      PyErr_SetString(PyExc_RuntimeError, "the sensor is already initialised");
+      return -1;
+  }
+  if(en >= 0) useGpio();
+  if(!openSerial(self, port, baud)) return -1;
+  self->uart = new DFRobot_SCW8916B_UART(self->serial, en);
+  self->sensor = self->uart;
+  return 0;
+}
+
+static int IO_init(sSensorObject_t *self, PyObject *args, PyObject *kwds){
+  static const char *kwlist[] = {"out", "en", "test", "port", "baud", NULL};
+  const char *port = NULL;
+  unsigned long baud = 9600;
+  int out, en = -1, test = -1;
+  if(!PyArg_ParseTupleAndKeywords(args, kwds, "i|iizk", (char **)kwlist, &out, &en, &test, &port, &baud)) return -1;
+  if(self->sensor != NULL){
+      PyErr_SetString(PyExc_RuntimeError, "the sensor is already initialised");
+      return -1;
+  }
+  useGpio();
+  if(port != NULL && !openSerial(self, port, baud)) return -1;
+  self->io = new DFRobot_SCW8916B_IO(out, en, test, self->serial);
+  self->sensor = self->io;
+  return 0;
+}
+
+static PyObject *Sensor_begin(sSensorObject_t *self, PyObject *args){
+  unsigned int budget = SCW8916B_DISCOVERY_BUDGET;
+  int rslt;
+  if(!PyArg_ParseTuple(args, "|I", &budget) || !ready(self)) return NULL;
+  if(budget > 0xFFFF) budget = 0xFFFF;
+  SENSOR_CALL(self, rslt = self->sensor->begin((uint16_t)budget));
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_detect_water(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->detectWater());
+  return PyLong_FromLong(rslt ? 1 : 0);
+}
+
+static PyObject *Sensor_detect_water_channels(sSensorObject_t *self, PyObject *unused){
+  uint8_t rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->detectWaterChannels());
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_poll(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->poll());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_available(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->available());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_last_state(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->lastState());
+  return PyLong_FromLong(rslt ? 1 : 0);
+}
+
+static PyObject *Sensor_last_channels(sSensorObject_t *self, PyObject *unused){
+  uint8_t rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->lastChannels());
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_wait(sSensorObject_t *self, PyObject *args, PyObject *kwds){
+  static const char *kwlist[] = {"timeout", NULL};
+  PyObject *timeout = Py_None;
+  std::vector<sSensorObject_t *> sensors(1, self);
+  std::vector<uint8_t> changes;
+  int ms, rslt;
+  if(!PyArg_ParseTupleAndKeywords(args, kwds, "|O", (char **)kwlist, &timeout) || !ready(self)) return NULL;
+  if(timeoutMs(timeout, &ms) < 0) return NULL;
+  rslt = waitInterruptible(sensors, changes, ms);
+  if(rslt < 0) return NULL;
+  if(rslt == 0) Py_RETURN_NONE;
+  return PyLong_FromLong(changes[0]);
+}
+
+static PyObject *Sensor_iter(PyObject *self){
+  Py_INCREF(self);
+  return self;
+}
+
+static PyObject *Sensor_next(sSensorObject_t *self){
+  std::vector<sSensorObject_t *> sensors(1, self);
+  std::vector<uint8_t> changes;
+  if(!ready(self)) return NULL;
+  if(waitInterruptible(sensors, changes, -1) < 0) return NULL;
+  return PyLong_FromLong(changes[0]);
+}
+
+static PyObject *Sensor_fileno(sSensorObject_t *self, PyObject *unused){
+  (void)unused;
+  if(!ready(self)) return NULL;
+  return PyLong_FromLong(sensorFd(self));
+}
+
+static PyObject *Sensor_self_check(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->selfCheck());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_calibration(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->calibration());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_start_self_check(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->startSelfCheck());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_start_calibration(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->startCalibration());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_step(sSensorObject_t *self, PyObject *unused){
+  DFRobot_Nilometer::eOpState_t rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->step());
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_get_op_state(sSensorObject_t *self, PyObject *unused){
+  DFRobot_Nilometer::eOpState_t rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->getOpState());
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_check_calibration_state(sSensorObject_t *self, PyObject *unused){
+  bool rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->checkCalibrationState());
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *Sensor_get_sensitivity_level(sSensorObject_t *self, PyObject *unused){
+  uint8_t rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->getSensitivity());
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_get_calibration_mode(sSensorObject_t *self, PyObject *unused){
+  uint8_t rslt;
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->sensor->getCalibrationMode());
+  return PyLong_FromLong(rslt);
+}
+
+static PyObject *Sensor_flush(sSensorObject_t *self, PyObject *unused){
+  (void)unused;
+  if(!ready(self)) return NULL;
+  SENSOR_CALL(self, self->sensor->flush());
+  Py_RETURN_NONE;
+}
+
+static PyObject *UART_set_sensitivity_level(sSensorObject_t *self, PyObject *args){
+  unsigned char level;
+  bool rslt;
+  if(!PyArg_ParseTuple(args, "b", &level) || !ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->uart->setSensitivityLevel((uint8_t)level));
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *UART_set_sensitivity_levels(sSensorObject_t *self, PyObject *args){
+  unsigned char levels[4];
+  uint8_t buf[4];
+  bool rslt;
+  if(!PyArg_ParseTuple(args, "(bbbb)", &levels[0], &levels[1], &levels[2], &levels[3]) || !ready(self)) return NULL;
+  for(uint8_t i = 0; i < 4; i++){
+      buf[i] = levels[i];
+  }
+  SENSOR_CALL(self, rslt = self->uart->setSensitivityLevels(buf));
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *UART_start_set_sensitivity_level(sSensorObject_t *self, PyObject *args){
+  unsigned char level;
+  bool rslt;
+  if(!PyArg_ParseTuple(args, "b", &level) || !ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->uart->startSetSensitivityLevel((uint8_t)level));
+  return PyBool_FromLong(rslt);
+}
+
+static PyObject *UART_get_channel_sensitivity(sSensorObject_t *self, PyObject *args){
+  unsigned char channel;
+  uint8_t rslt;
+  if(!PyArg_ParseTuple(args, "b", &channel) || !ready(self)) return NULL;
+  SENSOR_CALL(self, rslt = self->uart->getSensitivity((uint8_t)channel));
+  return PyLong_FromLong(rslt);
+}
+
+static PyMethodDef Sensor_methods[] = {
+  {"begin", (PyCFunction)Sensor_begin, METH_VARARGS,
+   "begin(budget=8000) -> 0: sucess, 0xAA: the sensor has never been calibrated, -1: fail"},
+  {"detect_water", (PyCFunction)Sensor_detect_water, METH_NOARGS,
+   "detect_water() -> 1: water, 0: no water. Blocking(100ms), the same as the pure Python driver"},
+  {"detect_water_channels", (PyCFunction)Sensor_detect_water_channels, METH_NOARGS,
+   "detect_water_channels() -> water state mask of the 4 channels, 0xFF: no valid frame"},
+  {"poll", (PyCFunction)Sensor_poll, METH_NOARGS,
+   "poll() -> True if a new water state arrived, never blocks"},
+  {"available", (PyCFunction)Sensor_available, METH_NOARGS,
+   "available() -> True if poll received a water state which has not been read"},
+  {"last_state", (PyCFunction)Sensor_last_state, METH_NOARGS,
+   "last_state() -> 1: water, 0: no water, the state received by poll"},
+  {"last_channels", (PyCFunction)Sensor_last_channels, METH_NOARGS,
+   "last_channels() -> water state mask received by poll, 0xFF: no valid state"},
+  {"wait", (PyCFunction)Sensor_wait, METH_VARARGS | METH_KEYWORDS,
+   "wait(timeout=None) -> the new water state mask, None on timeout(seconds). Releases the GIL while waiting"},
+  {"fileno", (PyCFunction)Sensor_fileno, METH_NOARGS,
+   "fileno() -> file descriptor of the serial port for select/selectors/asyncio, -1: no serial port or IO sensor"},
+  {"self_check", (PyCFunction)Sensor_self_check, METH_NOARGS,
+   "self_check() -> True: the sensitivity level and the calibration mode are updated"},
+  {"calibration", (PyCFunction)Sensor_calibration, METH_NOARGS,
+   "calibration() -> True: lower water level calibration sucess"},
+  {"start_self_check", (PyCFunction)Sensor_start_self_check, METH_NOARGS,
+   "start_self_check() -> True: the asynchronous self check is started, then call step()"},
+  {"start_calibration", (PyCFunction)Sensor_start_calibration, METH_NOARGS,
+   "start_calibration() -> True: the asynchronous calibration is started, then call step()"},
+  {"step", (PyCFunction)Sensor_step, METH_NOARGS,
+   "step() -> OP_IDLE, OP_BUSY, OP_DONE or OP_FAILED, advances the asynchronous operation, never blocks"},
+  {"get_op_state", (PyCFunction)Sensor_get_op_state, METH_NOARGS,
+   "get_op_state() -> the state of the asynchronous operation, the same as step()"},
+  {"check_calibration_state", (PyCFunction)Sensor_check_calibration_state, METH_NOARGS,
+   "check_calibration_state() -> True: calibration completed"},
+  {"get_sensitivity_level", (PyCFunction)Sensor_get_sensitivity_level, METH_NOARGS,
+   "get_sensitivity_level() -> 0~7, 0xFF: error, updated by self_check"},
+  {"get_calibration_mode", (PyCFunction)Sensor_get_calibration_mode, METH_NOARGS,
+   "get_calibration_mode() -> 0: lower level, 1: lower and upper level, 0xFF: error, updated by self_check"},
+  {"flush", (PyCFunction)Sensor_flush, METH_NOARGS,
+   "flush() -> clear the receive buffer of the serial port"},
+  {NULL, NULL, 0, NULL}
+};
+
+static PyMethodDef UART_methods[] = {
+  {"set_sensitivity_level", (PyCFunction)UART_set_sensitivity_level, METH_VARARGS,
+   "set_sensitivity_level(level) -> True: set sensitivity of channel 1 sucess, level 0~7"},
+  {"set_sensitivity_levels", (PyCFunction)UART_set_sensitivity_levels, METH_VARARGS,
+   "set_sensitivity_levels((l1, l2, l3, l4)) -> True: set sensitivity of the 4 channels sucess"},
+  {"start_set_sensitivity_level", (PyCFunction)UART_start_set_sensitivity_level, METH_VARARGS,
+   "start_set_sensitivity_level(level) -> True: the asynchronous configuration is started, then call step()"},
+  {"get_channel_sensitivity", (PyCFunction)UART_get_channel_sensitivity, METH_VARARGS,
+   "get_channel_sensitivity(channel) -> the level which was configured on channel 0~3, 0xFF: unknown"},
+  {NULL, NULL, 0, NULL}
+};
+
+static PyTypeObject SensorType = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+};
+static PyTypeObject UARTType = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+};
+static PyTypeObject IOType = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+};
+
+static PyObject *scw8916b_wait_any(PyObject *module, PyObject *args, PyObject *kwds){
+  static const char *kwlist[] = {"sensors", "timeout", NULL};
+  PyObject *seq, *items, *timeout = Py_None, *rslt;
+  std::vector<sSensorObject_t *> sensors;
+  std::vector<uint8_t> changes;
+  Py_ssize_t n;
+  int ms, found;
+  (void)module;
+  if(!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", (char **)kwlist, &seq, &timeout)) return NULL;
+  if(timeoutMs(timeout, &ms) < 0) return NULL;
+  items = PySequence_Fast(seq, "sensors must be a sequence");
+  if(items == NULL) return NULL;
+  n = PySequence_Fast_GET_SIZE(items);
+  for(Py_ssize_t i = 0; i < n; i++){
+      PyObject *item = PySequence_Fast_GET_ITEM(items, i);
+      if(!PyObject_TypeCheck(item, &SensorType)){
+          Py_DECREF(items);
+          PyErr_SetString(PyExc_TypeError, "sensors must be UART or IO objects");
+          return NULL;
+      }
+      if(!ready((sSensorObject_t *)item)){
+          Py_DECREF(items);
+          return NULL;
+      }
+      sensors.push_back((sSensorObject_t *)item);
+  }
+  found = waitInterruptible(sensors, changes, ms);
+  if(found < 0){
+      Py_DECREF(items);
+      return NULL;
+  }
+  rslt = PyList_New(0);
+  for(size_t i = 0; rslt != NULL && i < sensors.size(); i++){
+      if(changes[i] == ERR_CHANNELS_CODE) continue;
+      PyObject *pair = Py_BuildValue("(Oi)", (PyObject *)sensors[i], changes[i]);
+      if(pair == NULL || PyList_Append(rslt, pair) < 0){
+          Py_XDECREF(pair);
+          Py_CLEAR(rslt);
+          break;
+      }
+      Py_DECREF(pair);
+  }
+  Py_DECREF(items);
+  return rslt;
+}
+
+static PyObject *scw8916b_set_gpio_base(PyObject *module, PyObject *args, PyObject *kwds){
+  static const char *kwlist[] = {"base", "root", NULL};
+  const char *root = NULL;
+  int base;
+  (void)module;
+  if(!PyArg_ParseTupleAndKeywords(args, kwds, "i|s", (char **)kwlist, &base, &root)) return NULL;
+  if(_gpio != NULL){
+      PyErr_SetString(PyExc_RuntimeError, "set_gpio_base must be called before the first sensor with pins is created");
+      return NULL;
+  }
+  if(root != NULL && strlen(root) >= sizeof(_gpioRoot)){
+      PyErr_SetString(PyExc_ValueError, "root is too long");
+      return NULL;
+  }
+  _gpioBase = base;
+  if(root != NULL) snprintf(_gpioRoot, sizeof(_gpioRoot), "%s", root);
+  Py_RETURN_NONE;
+}
+
+static PyMethodDef scw8916b_methods[] = {
+  {"wait_any", (PyCFunction)scw8916b_wait_any, METH_VARARGS | METH_KEYWORDS,
+   "wait_any(sensors, timeout=None) -> list of (sensor, water state mask) which changed, [] on timeout(seconds)"},
+  {"set_gpio_base", (PyCFunction)scw8916b_set_gpio_base, METH_VARARGS | METH_KEYWORDS,
+   "set_gpio_base(base, root='/sys/class/gpio') -> the sysfs GPIO number of BCM pin 0(the gpiochip base), default 0, "
+   "and the sysfs GPIO directory"},
+  {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef scw8916b_module = {
+  PyModuleDef_HEAD_INIT,
+  "scw8916b",
+  "Non-contact liquid level sensor driver on top of the DFRobot_SCW8916B C++ library",
+  -1,
+  scw8916b_methods,
+  NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_scw8916b(void){
+  PyObject *m;
+  SensorType.tp_name = "scw8916b.Nilometer";
+  SensorType.tp_basicsize = sizeof(sSensorObject_t);
+  SensorType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+  SensorType.tp_doc = "Common methods of the UART and IO sensors";
+  SensorType.tp_dealloc = (destructor)Sensor_dealloc;
+  SensorType.tp_iter = Sensor_iter;
+  SensorType.tp_iternext = (iternextfunc)Sensor_next;
+  SensorType.tp_methods = Sensor_methods;
+
+  UARTType.tp_name = "scw8916b.UART";
+  UARTType.tp_basicsize = sizeof(sSensorObject_t);
+  UARTType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+  UARTType.tp_doc = "UART(port='/dev/ttyAMA0', baud=9600, en=-1): UART detection mode";
+  UARTType.tp_base = &SensorType;
+  UARTType.tp_new = Sensor_new;
+  UARTType.tp_init = (initproc)UART_init;
+  UARTType.tp_methods = UART_methods;
+
+  IOType.tp_name = "scw8916b.IO";
+  IOType.tp_basicsize = sizeof(sSensorObject_t);
+  IOType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+  IOType.tp_doc = "IO(out, en=-1, test=-1, port=None, baud=9600): level one-to-one detection mode, "
+                  "port is the serial port which receives the self check result";
+  IOType.tp_base = &SensorType;
+  IOType.tp_new = Sensor_new;
+  IOType.tp_init = (initproc)IO_init;
+
+  if(PyType_Ready(&SensorType) < 0 || PyType_Ready(&UARTType) < 0 || PyType_Ready(&IOType) < 0) return NULL;
+  m = PyModule_Create(&scw8916b_module);
+  if(m == NULL) return NULL;
+  Py_INCREF(&SensorType);
+  Py_INCREF(&UARTType);
+  Py_INCREF(&IOType);
+  if(PyModule_AddObject(m, "Nilometer", (PyObject *)&SensorType) < 0 ||
+     PyModule_AddObject(m, "UART", (PyObject *)&UARTType) < 0 ||
+     PyModule_AddObject(m, "IO", (PyObject *)&IOType) < 0){
+      Py_DECREF(m);
+      return NULL;
+  }
+  PyModule_AddIntConstant(m, "ERR_CALIBRATION_CODE", ERR_CALIBRATION_CODE);
+  PyModule_AddIntConstant(m, "ERR_CHANNELS_CODE", ERR_CHANNELS_CODE);
+  PyModule_AddIntConstant(m, "WATER_CHANNEL_1", WATER_CHANNEL_1);
+  PyModule_AddIntConstant(m, "WATER_CHANNEL_2", WATER_CHANNEL_2);
+  PyModule_AddIntConstant(m, "WATER_CHANNEL_3", WATER_CHANNEL_3);
+  PyModule_AddIntConstant(m, "WATER_CHANNEL_4", WATER_CHANNEL_4);
+  PyModule_AddIntConstant(m, "CALIBRATION_MODE_LOWER_LEVEL", CALIBRATION_MODE_LOWER_LEVEL);
+  PyModule_AddIntConstant(m, "CALIBRATION_MODE_LOWER_AND_UPPER_LEVEL", CALIBRATION_MODE_LOWER_AND_UPPER_LEVEL);
+  PyModule_AddIntConstant(m, "OP_IDLE", DFRobot_Nilometer::eOpIdle);
+  PyModule_AddIntConstant(m, "OP_BUSY", DFRobot_Nilometer::eOpBusy);
+  PyModule_AddIntConstant(m, "OP_DONE", DFRobot_Nilometer::eOpDone);
+  PyModule_AddIntConstant(m, "OP_FAILED", DFRobot_Nilometer::eOpFailed);
+  hostUseRealClock(true);
+  return m;
+}
@@ -0,0 +1,41 @@
+# -*- coding: utf-8 -*
+'''!
+  @file setup.py
+  @brief Build the scw8916b extension: the C++ library, the Arduino shim of extras/host and the Linux backend
+  @n of extras/linux, wrapped for CPython.
+  @n   cd python/raspberrypi/native && python3 setup.py build_ext --inplace
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @licence     The MIT License (MIT)
+  @author [Arya](xue.peng@dfrobot.com)
+  @version  V1.0
+  @date  2021-04-22
+  @https://github.com/DFRobot/DFRobot_SCW8916B
+'''
+import glob
+import os
+from setuptools import setup, Extension
+
+here = os.path.dirname(os.path.abspath(__file__))
+root = os.path.relpath(os.path.join(here, '..', '..', '..'), here)
+os.chdir(here)
+
+src_dir = os.path.join(root, 'src')
+host_dir = os.path.join(root, 'extras', 'host')
+linux_dir = os.path.join(root, 'extras', 'linux')
+
+sources = ['scw8916b_module.cpp',
+           os.path.join(host_dir, 'HostArduino.cpp'),
+           os.path.join(linux_dir, 'LinuxSerial.cpp'),
+           os.path.join(linux_dir, 'LinuxGpio.cpp')]
+sources += sorted(glob.glob(os.path.join(src_dir, '*.cpp')))
+
+setup(
+  name = 'scw8916b',
+  version = '1.0.0',
+  description = 'Non-contact liquid level sensor driver on top of the DFRobot_SCW8916B C++ library',
+  ext_modules = [Extension('scw8916b', sources = sources,
+                           include_dirs = [linux_dir, host_dir, src_dir],
+                           define_macros = [('ARDUINO', '10813')],
+                           extra_compile_args = ['-std=c++11', '-Wall'],
+                           language = 'c++')],
+)
@@ -0,0 +1,122 @@
+# -*- coding: utf-8 -*
+'''!
+  @file test_native.py
+  @brief Host test of the scw8916b extension without a sensor: the serial ports are pseudo terminals and the
+  @n GPIO is a directory with the layout of /sys/class/gpio(gpioN/value), so it runs on any Linux machine.
+  @n   cd python/raspberrypi/native && python3 setup.py build_ext --inplace && python3 test_native.py
+  @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @licence     The MIT License (MIT)
+  @author [Arya](xue.peng@dfrobot.com)
+  @version  V1.0
+  @date  2021-04-22
+  @https://github.com/DFRobot/DFRobot_SCW8916B
+'''
+import errno
+import os
+import shutil
+import signal
+import tempfile
+import threading
+import time
+import unittest
+
+import scw8916b
+
+OUT_PIN = 5
+
+gpio_root = tempfile.mkdtemp(prefix = 'scw8916b_gpio_')
+scw8916b.set_gpio_base(0, root = gpio_root)
+
+def set_out(val):
+  with open(os.path.join(gpio_root, 'gpio%d' % OUT_PIN, 'value'), 'w') as f:
+    f.write('1\n' if val else '0\n')
+
+def open_port():
+  '''! @return (master fd, slave path) of a new pseudo terminal, nothing is ever written to the slave'''
+  master, slave = os.openpty()
+  path = os.ttyname(slave)
+  os.close(slave)
+  return master, path
+
+class IOWithPortTest(unittest.TestCase):
+  '''! An IO sensor with a serial port(self check) must still see the edges of OUT while the port is silent'''
+
+  def setUp(self):
+    os.makedirs(os.path.join(gpio_root, 'gpio%d' % OUT_PIN), exist_ok = True)
+    set_out(0)
+    self.master, path = open_port()
+    self.sensor = scw8916b.IO(OUT_PIN, port = path)
+
+  def tearDown(self):
+    del self.sensor
+    os.close(self.master)
+
+  def test_fileno(self):
+    self.assertEqual(self.sensor.fileno(), -1)
+
+  def test_wait_forever(self):
+    self.assertEqual(self.sensor.wait(0), 0)
+    threading.Timer(0.2, set_out, (1,)).start()
+    start = time.monotonic()
+    self.assertEqual(self.sensor.wait(None), 1)
+    self.assertLess(time.monotonic() - start, 1.0)
+
+  def test_wait_any_and_iterator(self):
+    self.assertEqual(scw8916b.wait_any([self.sensor], 0), [(self.sensor, 0)])
+    threading.Timer(0.2, set_out, (1,)).start()
+    self.assertEqual(scw8916b.wait_any([self.sensor], None), [(self.sensor, 1)])
+    threading.Timer(0.2, set_out, (0,)).start()
+    self.assertEqual(next(iter(self.sensor)), 0)
+
+class InterruptTest(unittest.TestCase):
+  '''! Ctrl-C interrupts a wait without timeout on a silent serial port'''
+
+  def setUp(self):
+    self.master, path = open_port()
+    self.sensor = scw8916b.UART(port = path)
+
+  def tearDown(self):
+    del self.sensor
+    os.close(self.master)
+
+  def interrupt(self, wait):
+    timer = threading.Timer(0.2, os.kill, (os.getpid(), signal.SIGINT))
+    timer.start()
+    start = time.monotonic()
+    with self.assertRaises(KeyboardInterrupt):
+      wait()
+    self.assertLess(time.monotonic() - start, 1.5)
+    timer.join()
+
+  def test_wait(self):
+    self.interrupt(lambda: self.sensor.wait(None))
+
+  def test_wait_any(self):
+    self.interrupt(lambda: scw8916b.wait_any([self.sensor], None))
+
+  def test_timeout(self):
+    start = time.monotonic()
+    self.assertIsNone(self.sensor.wait(0.3))
+    self.assertGreaterEqual(time.monotonic() - start, 0.29)
+
+class OpenTest(unittest.TestCase):
+  '''! A port which cannot run at the requested speed raises OSError instead of talking at the wrong speed'''
+
+  def test_not_a_tty(self):
+    with self.assertRaises(OSError):
+      scw8916b.UART(port = '/dev/null')
+
+  def test_unsupported_baud(self):
+    master, path = open_port()
+    try:
+      with self.assertRaises(OSError) as ctx:
+        scw8916b.UART(port = path, baud = 12345)
+      self.assertEqual(ctx.exception.errno, errno.EINVAL)
+    finally:
+      os.close(master)
+
+if __name__ == '__main__':
+  try:
+    unittest.main()
+  finally:
+    shutil.rmtree(gpio_root, ignore_errors = True)
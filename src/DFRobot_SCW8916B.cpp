@@ -15,11 +15,62 @@
 #include <Arduino.h>
 #include "DFRobot_SCW8916B.h"
 
+#if SCW8916B_ENABLE_STATS
+#define STATS_START()               uint32_t statStart = micros()
+#define STATS_RECORD(op, timeout)   _stats.record(op, micros() - statStart, timeout)
+#else
+#define STATS_START()
+#define STATS_RECORD(op, timeout)   (void)(timeout)
+#endif
+
+#if SCW8916B_ENABLE_HEALTH
+#define HEALTH_STATE(state)   _health.onState(state, millis())
+#define HEALTH_COMMAND(ok)    _health.onCommand(ok)
+#define HEALTH_UNCALIBRATED() _health.onUncalibrated()
+#else
+#define HEALTH_STATE(state)
+#define HEALTH_COMMAND(ok)
+#define HEALTH_UNCALIBRATED()
+#endif
+
+#if SCW8916B_ENABLE_TRACE
+#define PIN_READ(pin)         tracePinRead(pin)
+#define PIN_WRITE(pin, val)   tracePinWrite(pin, val)
+#else
+#define PIN_READ(pin)         digitalRead(pin)
+#define PIN_WRITE(pin, val)   digitalWrite(pin, val)
+#endif
+
 DFRobot_Nilometer::DFRobot_Nilometer(Stream *s, int en)
   :_s(s),_out(-1),_test(-1),_en(en)
 {
   _mode = eUARTDetecteMode;
   memset(&_rslt, 0, sizeof(_rslt));
+  _state = 0;
+  _stateValid = false;
+  _newState = false;
+  _op = eOpNone;
+  _opState = eOpIdle;
+  memset(_senLevels, 0xFF, sizeof(_senLevels));
+  _store = NULL;
+  _calibrated = false;
+  _discoveryTime = 0;
+  _session = false;
+  _powered = false;
+  _enableMs = 0;
+  _offMs = 0;
+  _off = false;
+  _opPowered = false;
+  _opMarker = false;
+  memset(&_sample, 0, sizeof(_sample));
+  _sample.warmup = SAMPLE_WARMUP_INIT;
+  _edgeSlotIndex = -1;
+  _edgeHead = 0;
+  _edgeTail = 0;
+  _edgeOverflows = 0;
+#if SCW8916B_ENABLE_TRACE
+  _trace = NULL;
+#endif
 }
 
 DFRobot_Nilometer::DFRobot_Nilometer(int out, int en, int test, Stream *s)
@@ -27,32 +78,96 @@ DFRobot_Nilometer::DFRobot_Nilometer(int out, int en, int test, Stream *s)
 {
   _mode = eLevelDetecteMode;
   memset(&_rslt, 0, sizeof(_rslt));
+  _state = 0;
+  _stateValid = false;
+  _newState = false;
+  _op = eOpNone;
+  _opState = eOpIdle;
+  memset(_senLevels, 0xFF, sizeof(_senLevels));
+  _store = NULL;
+  _calibrated = false;
+  _discoveryTime = 0;
+  _session = false;
+  _powered = false;
+  _enableMs = 0;
+  _offMs = 0;
+  _off = false;
+  _opPowered = false;
+  _opMarker = false;
+  memset(&_sample, 0, sizeof(_sample));
+  _sample.warmup = SAMPLE_WARMUP_INIT;
+  _edgeSlotIndex = -1;
+  _edgeHead = 0;
+  _edgeTail = 0;
+  _edgeOverflows = 0;
+#if SCW8916B_ENABLE_TRACE
+  _trace = NULL;
+#endif
+}
+
+DFRobot_Nilometer::~DFRobot_Nilometer(){
+  disableEdgeCapture();
 }
 
-DFRobot_Nilometer::~DFRobot_Nilometer(){}
+#if SCW8916B_ENABLE_TRACE
+void DFRobot_Nilometer::setTrace(DFRobot_SCW8916B_Trace *trace){
+  Stream *s = (_s == &_traceStream) ? _traceStream.stream() : _s;
+  _trace = trace;
+  if(trace != NULL) trace->record(eTraceMark, 0);
+  if(trace != NULL && s != NULL){
+      _traceStream.begin(s, trace);
+      _s = &_traceStream;
+  }else{
+      _s = s;
+  }
+}
+
+int DFRobot_Nilometer::tracePinRead(int pin){
+  int val = digitalRead(pin);
+  if(_trace != NULL) _trace->recordPinRead((uint8_t)pin, val ? 1 : 0);
+  return val;
+}
+
+void DFRobot_Nilometer::tracePinWrite(int pin, uint8_t val){
+  if(_trace != NULL) _trace->record(eTracePinWrite, (uint8_t)((pin << 1) | (val ? 1 : 0)));
+  digitalWrite(pin, val);
+}
+#endif
+
+DFRobot_Nilometer *DFRobot_Nilometer::_edgeSlot[SCW8916B_EDGE_CAPTURE_SLOTS] = {NULL};
 
 //需要判定一下是否从来没有校准
-int DFRobot_Nilometer::begin(){
-  uint8_t val = 0,val1=0;
-  int waitForTimeOutMs = 8000;
-  int waitForTimeoutIncMs = 100;
-  uint8_t count = 0;
-  int t = 0;
-
-  uCheckRslt_t rslt;
+int DFRobot_Nilometer::begin(uint16_t budget){
+  uint32_t start = millis();
+  uint32_t deadline = start + budget;
+  DFRobot_SCW8916B_Protocol::sToggleWatch_t watch;
+  uint8_t type;
+  int ret = 0;
+  bool timeout = false;
+  STATS_START();
+
   if(_mode == eUARTDetecteMode){
       if(_s == NULL){
           DBG("Error: _s is NULL.");
           return -1;
       }
-      while((val1 = _s->read()) != ERR_CALIBRATION_CODE){
-          delay(waitForTimeoutIncMs);
-          t += waitForTimeoutIncMs;
-          memcpy(&rslt, &val1, 1);
-          if(rslt.value + rslt.pad == 0x0F) return 0;
-          if(t > waitForTimeOutMs){
-              return 0;
-          } 
+      while(1){
+          pump();
+          type = drainEvents();
+          if(type == DFRobot_SCW8916B_Parser::eEventDetect){
+              _calibrated = true;
+              break;
+          }
+          if(type == DFRobot_SCW8916B_Parser::eEventUncalibrated){
+              _calibrated = false;
+              ret = ERR_CALIBRATION_CODE;
+              break;
+          }
+          if(expired(deadline)){
+              timeout = true;
+              break;
+          }
+          delay(1);
       }
   }else{
       if(_out == -1){
@@ -60,48 +175,172 @@ int DFRobot_Nilometer::begin(){
           return -1;
       }
       pinMode(_out, INPUT);
-
-      val = digitalRead(_out);
-      while((val1 = digitalRead(_out)) == val){
-          delay(waitForTimeoutIncMs);
-          t += waitForTimeoutIncMs;
-          if(t > waitForTimeOutMs){
-              return 0;
-          } 
-      }
-      val = val1;
-      for(int i = 0; i < 5; i++){
-          delay(100);
-          val1 = digitalRead(_out);
-          if(val + val1 == 1){
-              count++;
-              return 0;
+      DFRobot_SCW8916B_Protocol::toggleStart(&watch, PIN_READ(_out), start);
+      while(!expired(deadline)){
+          if(DFRobot_SCW8916B_Protocol::toggleUpdate(&watch, PIN_READ(_out), millis())){
+              _calibrated = false;
+              ret = ERR_CALIBRATION_CODE;
+              break;
           }
+          delay(1);
       }
-      if(count < 2) return 0;
+      // OUT did not toggle like an uncalibrated sensor for the whole budget
+      if(ret == 0) _calibrated = true;
   }
-  return ERR_CALIBRATION_CODE;
+  _discoveryTime = millis() - start;
+  STATS_RECORD(eStatBegin, timeout);
+  return ret;
+}
+
+uint32_t DFRobot_Nilometer::getDiscoveryTime(){
+  return _discoveryTime;
 }
 
 bool DFRobot_Nilometer::detectWater(){
+  uint8_t channels = detectWaterChannels();
+  if(channels == ERR_CHANNELS_CODE){
+      return false;
+  }
+  return (bool)(channels & WATER_CHANNEL_1);
+}
+
+uint8_t DFRobot_Nilometer::detectWaterChannels(){
+  uint8_t channels = ERR_CHANNELS_CODE;
+  STATS_START();
+  if(poll() || (_mode == eLevelDetecteMode && _stateValid)){
+      channels = lastChannels();
+  }
+  delay(100);
+  STATS_RECORD(eStatDetect, channels == ERR_CHANNELS_CODE);
+  return channels;
+}
+
+bool DFRobot_Nilometer::poll(){
   bool flag = false;
-  uCheckRslt_t rslt;
+  uint8_t val;
+  STATS_START();
   if(_mode == eUARTDetecteMode){
-      readData(&rslt, 1);
-      if(rslt.pad+rslt.value == 0x0F){
-          flag = ( bool)rslt.ch1;
+      if(_s == NULL) return false;
+      pump();
+      flag = (drainEvents() == DFRobot_SCW8916B_Parser::eEventDetect);
+  }else if(_out < 0){
+      return false;
+  }else if(_edgeSlotIndex >= 0 && _stateValid){
+      uint32_t t;
+      while(popEdge(&t, &val)){
+          HEALTH_STATE(val);
+          if(val != _state){
+              _state = val;
+              _newState = true;
+              flag = true;
+          }
       }
-      flush();
+      HEALTH_STATE(_state);
   }else{
-      if(digitalRead(_out)){
-          flag = true;
-      }
-      
+      flag = pollLevel(PIN_READ(_out));
   }
-  delay(100);
+  STATS_RECORD(eStatPoll, false);
   return flag;
 }
 
+bool DFRobot_Nilometer::pollLevel(uint8_t level){
+  if(_mode != eLevelDetecteMode) return false;
+  level = level ? 1 : 0;
+  HEALTH_STATE(level);
+  if(_stateValid && (level == _state)) return false;
+  _state = level;
+  _stateValid = true;
+  _newState = true;
+  return true;
+}
+
+int DFRobot_Nilometer::getOutPin(){
+  return (_mode == eLevelDetecteMode) ? _out : -1;
+}
+
+bool DFRobot_Nilometer::enableEdgeCapture(){
+  static void (* const isr[SCW8916B_EDGE_CAPTURE_SLOTS])() = {edgeIsr0, edgeIsr1, edgeIsr2, edgeIsr3};
+  int irq;
+  if(_mode != eLevelDetecteMode || _out < 0) return false;
+  if(_edgeSlotIndex >= 0) return true;
+  irq = digitalPinToInterrupt(_out);
+  if(irq == NOT_AN_INTERRUPT) return false;
+  for(uint8_t i = 0; i < SCW8916B_EDGE_CAPTURE_SLOTS; i++){
+      if(_edgeSlot[i] == NULL){
+          pinMode(_out, INPUT);
+          _edgeHead = 0;
+          _edgeTail = 0;
+          _edgeSlot[i] = this;
+          _edgeSlotIndex = i;
+          attachInterrupt(irq, isr[i], CHANGE);
+          return true;
+      }
+  }
+  return false;
+}
+
+void DFRobot_Nilometer::disableEdgeCapture(){
+  if(_edgeSlotIndex < 0) return;
+  detachInterrupt(digitalPinToInterrupt(_out));
+  _edgeSlot[_edgeSlotIndex] = NULL;
+  _edgeSlotIndex = -1;
+}
+
+bool DFRobot_Nilometer::popEdge(uint32_t *t, uint8_t *level){
+  uint8_t tail = _edgeTail;
+  if(tail == _edgeHead) return false;
+  SCW8916B_EDGE_BARRIER();   // read the record only after the head which published it
+  sEdge_t *edge = &_edge[tail & (SCW8916B_EDGE_QUEUE_SIZE - 1)];
+  *t = edge->t;
+  *level = edge->level;
+  SCW8916B_EDGE_BARRIER();   // release the slot only after it has been read
+  _edgeTail = tail + 1;
+  return true;
+}
+
+uint32_t DFRobot_Nilometer::getEdgeOverflows(){
+  uint32_t overflows;
+  noInterrupts();            // 32-bit read is not atomic on AVR
+  overflows = _edgeOverflows;
+  interrupts();
+  return overflows;
+}
+
+void IRAM_ATTR DFRobot_Nilometer::onEdge(){
+  uint8_t head = _edgeHead;
+  if((uint8_t)(head - _edgeTail) >= SCW8916B_EDGE_QUEUE_SIZE){
+      _edgeOverflows++;
+      return;
+  }
+  sEdge_t *edge = &_edge[head & (SCW8916B_EDGE_QUEUE_SIZE - 1)];
+  edge->t = millis();
+  edge->level = digitalRead(_out) ? 1 : 0;
+  SCW8916B_EDGE_BARRIER();   // the record is complete before the head publishes it
+  _edgeHead = head + 1;
+}
+
+void IRAM_ATTR DFRobot_Nilometer::edgeIsr0(){ if(_edgeSlot[0]) _edgeSlot[0]->onEdge(); }
+void IRAM_ATTR DFRobot_Nilometer::edgeIsr1(){ if(_edgeSlot[1]) _edgeSlot[1]->onEdge(); }
+void IRAM_ATTR DFRobot_Nilometer::edgeIsr2(){ if(_edgeSlot[2]) _edgeSlot[2]->onEdge(); }
+void IRAM_ATTR DFRobot_Nilometer::edgeIsr3(){ if(_edgeSlot[3]) _edgeSlot[3]->onEdge(); }
+
+bool DFRobot_Nilometer::available(){
+  return _newState;
+}
+
+bool DFRobot_Nilometer::lastState(){
+  _newState = false;
+  return (bool)(_state & WATER_CHANNEL_1);
+}
+
+uint8_t DFRobot_Nilometer::lastChannels(){
+  _newState = false;
+  if(!_stateValid){
+      return ERR_CHANNELS_CODE;
+  }
+  return _state;
+}
+
 bool DFRobot_Nilometer::selfCheck(){
   if(_mode == eUARTDetecteMode){
       return uartSelfCheck(_en);
@@ -121,68 +360,370 @@ bool DFRobot_Nilometer::calibration(){
   return flag;
 }
 
-//正在进行下水位校准（空水箱校准），请不要触碰检测区域
-bool DFRobot_Nilometer::uartWaterLevelCalibration(int en, uint8_t cmd){
-  int remain;
-  uint8_t val;
-  uCheckRslt_t rslt;
-  if(en < 0){
-      return false;
+bool DFRobot_Nilometer::startSelfCheck(){
+  if(_mode == eUARTDetecteMode){
+      if(_en < 0 || _s == NULL) return false;
+      uint8_t cmd = SELF_CHECK_CMD;
+      return startOp(eOpSelfCheck, &cmd, 1, 0, SELF_CHECK_UART_TIMEOUT);
   }
-  enableSensor(en);
-  writeData(&cmd, 1);
-  cmd = ((cmd >> 4) | (cmd << 4));
-  delay(1000);
-  remain = _s->available();
-  for(int i = 0; i < remain; i++){
-      val = _s->read();
-      if(val == cmd){
-          return true;
+  if(_en < 0 || _test < 0 || _out < 0 || _s == NULL) return false;
+  return startOp(eOpSelfCheck, NULL, 0, 0, SELF_CHECK_IO_TIMEOUT);
+}
+
+bool DFRobot_Nilometer::startCalibration(){
+  if(_mode == eUARTDetecteMode){
+      if(_en < 0 || _s == NULL) return false;
+      uint8_t cmd = CALIB_UART_CMD_LWL;
+      return startOp(eOpCalibration, &cmd, 1, DFRobot_SCW8916B_Protocol::calibrationAck(cmd), CALIB_TIMEOUT);
+  }
+  if(_en < 0 || _test < 0 || _out < 0 || _opState == eOpBusy) return false;
+  _opPulse = CALIB_IO_TIME_LWL;
+  return startOp(eOpCalibration, NULL, 0, 0, CALIB_TIMEOUT);
+}
+
+bool DFRobot_Nilometer::startOp(eOpType_t op, const uint8_t *cmd, uint8_t len, uint8_t ack, uint16_t timeout){
+  if(_opState == eOpBusy) return false;
+  _op = op;
+  _opAck = ack;
+  _opTimeout = timeout;
+  _opLen = (len > sizeof(_opCmd)) ? sizeof(_opCmd) : len;
+  if(cmd != NULL) memcpy(_opCmd, cmd, _opLen);
+  _opState = eOpBusy;
+#if SCW8916B_ENABLE_STATS
+  _opStartUs = micros();
+#endif
+  if(_mode == eLevelDetecteMode){
+      pinMode(_test, OUTPUT);
+      PIN_WRITE(_test, HIGH);
+  }
+  _opVal = 0;
+  _opPowered = false;
+  _opMarker = false;
+  if(sharePower(op) && op == eOpSample){
+      _opPhase = ePhaseWaitFrame;
+      _opStart = millis();
+      _opDeadline = _opStart + timeout;
+  }else if(sharePower(op)){
+      _opPhase = ePhaseSettle;
+      _opDeadline = (millis() - _enableMs >= POWER_SETTLE_TIME) ? millis() : _enableMs + POWER_SETTLE_TIME;
+  }else if(_en > -1){
+      pinMode(_en, OUTPUT);
+      PIN_WRITE(_en, LOW);
+      _opPhase = ePhasePowerOff;
+      // a sensor which is already off since the last sample needs no further off time
+      _opDeadline = _off ? _offMs + POWER_OFF_TIME : millis() + POWER_OFF_TIME;
+  }else{
+      _opPhase = ePhaseSettle;
+      _opDeadline = millis();
+  }
+  return true;
+}
+
+bool DFRobot_Nilometer::sharePower(eOpType_t op){
+  return _session && _powered && _en > -1 && _mode == eUARTDetecteMode && op != eOpCalibration;
+}
+
+void DFRobot_Nilometer::beginSession(){
+  _session = true;
+}
+
+void DFRobot_Nilometer::endSession(){
+  _session = false;
+}
+
+bool DFRobot_Nilometer::inSession(){
+  return _session;
+}
+
+uint32_t DFRobot_Nilometer::getEnableTime(){
+  return _enableMs;
+}
+
+void DFRobot_Nilometer::setStore(DFRobot_SCW8916B_Store *store){
+  _store = store;
+}
+
+bool DFRobot_Nilometer::saveSnapshot(){
+  sSnapshot_t snap;
+  if(_store == NULL || (_rslt.pad + _rslt.value != 0xFF)) return false;
+  snap.magic = SNAPSHOT_MAGIC;
+  snap.value = _rslt.value;
+  snap.pad = _rslt.pad;
+  snap.calibrated = _calibrated ? 1 : 0;
+  snap.cs = ~getCs(&snap, sizeof(snap) - 1);
+  return _store->write(&snap, sizeof(snap));
+}
+
+bool DFRobot_Nilometer::restoreSnapshot(){
+  sSnapshot_t snap;
+  if(_store == NULL || !_store->read(&snap, sizeof(snap))) return false;
+  if(snap.magic != SNAPSHOT_MAGIC || snap.cs != (uint8_t)~getCs(&snap, sizeof(snap) - 1)) return false;
+  if(snap.value + snap.pad != 0xFF) return false;
+  _rslt.value = snap.value;
+  _rslt.pad = snap.pad;
+  _calibrated = snap.calibrated ? true : false;
+  return true;
+}
+
+int DFRobot_Nilometer::warmBegin(uint16_t timeout){
+  uint32_t deadline = millis() + timeout;
+  uint8_t type;
+  if(!restoreSnapshot() || !_calibrated){
+      return begin();
+  }
+  if(_mode == eUARTDetecteMode){
+      if(_s == NULL) return -1;
+      while(!expired(deadline)){
+          pump();
+          type = drainEvents();
+          if(type == DFRobot_SCW8916B_Parser::eEventDetect) return 0;
+          if(type == DFRobot_SCW8916B_Parser::eEventUncalibrated){
+              _calibrated = false;
+              saveSnapshot();
+              return ERR_CALIBRATION_CODE;
+          }
+          delay(1);
       }
+      return begin();
   }
-  //flush();
-  return false;
+  if(_out == -1) return -1;
+  pinMode(_out, INPUT);
+  poll();
+  return 0;
 }
 
-bool DFRobot_Nilometer::ioWaterLevelCalibration(int en, int test, uint8_t t){
-  if(en < 0 || test < 0 || _out < 0) return false;
-  uint32_t t1 = 0,curT;
-  uint8_t val, val1;
-  int interT1 = 0, interT2 = 0;
-  pinMode(test, OUTPUT);
-  digitalWrite(test, HIGH);
-  enableSensor(en);
-  digitalWrite(test, LOW);
-  delay(t);
-  digitalWrite(test, HIGH);
-  t1 = millis();
-  val1 = digitalRead(_out);
-  curT = t1;
-  while(1){
-      val = digitalRead(_out);
-      if(val1 != val){
-          if(val1){
-              if(interT1 >= (t-10)){
-                  interT2 = millis() - t1;
-                  if(interT2 > 500) return true;
-                  else {
-                      interT1 = 0;
-                      interT2 = 0;
-                  }
-              }
+#if SCW8916B_ENABLE_STATS
+const sSCW8916BStats_t *DFRobot_Nilometer::getStats(){
+  _stats.data.bytesParsed = _parser.bytesParsed();
+  _stats.data.framesDecoded = _parser.framesDecoded();
+  _stats.data.checksumFailures = _parser.checksumFailures();
+  _stats.data.bytesDiscarded = _parser.bytesDiscarded();
+  _stats.data.eventsOverflowed = _parser.eventsOverflowed();
+  return &_stats.data;
+}
+
+void DFRobot_Nilometer::resetStats(){
+  _stats.reset();
+  _parser.resetCounters();
+}
+#endif
+
+#if SCW8916B_ENABLE_HEALTH
+const sSCW8916BHealth_t *DFRobot_Nilometer::getHealth(){
+  return _health.get(millis());
+}
+
+void DFRobot_Nilometer::resetHealth(){
+  _health.reset();
+}
+
+void DFRobot_Nilometer::setHealthLimits(uint32_t silentMs, uint32_t stuckMs){
+  _health.setLimits(silentMs, stuckMs);
+}
+#endif
+
+bool DFRobot_Nilometer::waitOp(){
+  while(step() == eOpBusy){
+      delay(1);
+  }
+  return _opState == eOpDone;
+}
+
+bool DFRobot_Nilometer::expired(uint32_t deadline){
+  return (int32_t)(millis() - deadline) >= 0;
+}
+
+void DFRobot_Nilometer::sendCommand(const void *cmd, uint8_t len, uint8_t ack){
+  if(ack){
+      _parser.expectAck(ack);
+  }else{
+      _parser.expectSelfCheck(true);
+  }
+  if(cmd != NULL && len){
+      writeData((void *)cmd, len);
+  }
+}
+
+DFRobot_Nilometer::eOpState_t DFRobot_Nilometer::checkReply(uint32_t deadline, DFRobot_SCW8916B_Parser::sEvent_t *ev){
+  pump();
+  if(_parser.reply(ev)){
+      return eOpDone;
+  }
+  if(expired(deadline)){
+      _parser.expectSelfCheck(false);
+      _parser.expectAck(0);
+      return eOpFailed;
+  }
+  return eOpBusy;
+}
+
+void DFRobot_Nilometer::finishOp(eOpState_t state){
+  _parser.expectSelfCheck(false);
+  _parser.expectAck(0);
+  if(state != eOpDone){
+      _powered = false;
+  }
+  _opState = state;
+  HEALTH_COMMAND(state == eOpDone);
+#if SCW8916B_ENABLE_STATS
+  _stats.record((_op == eOpSelfCheck) ? eStatSelfCheck : (_op == eOpCalibration) ? eStatCalibration :
+                (_op == eOpSample) ? eStatSample : eStatSensitivity, micros() - _opStartUs, state != eOpDone);
+#endif
+  if(_op == eOpSample){
+      finishSample(state);
+      return;
+  }
+  if(state == eOpDone && _op == eOpSensitivity){
+      memcpy(_senLevels, _senPending, sizeof(_senLevels));
+  }
+  if(state == eOpDone && _op != eOpSensitivity){
+      if(_op == eOpCalibration) _calibrated = true;
+      saveSnapshot();
+  }
+}
+
+void DFRobot_Nilometer::finishSample(eOpState_t state){
+  uint32_t now = millis();
+  uint32_t on = now - _opStart;
+  if(state == eOpDone){
+      _sample.samples++;
+      if(_opPowered){
+          uint32_t warmup = _opT1 - _opStart;
+          _sample.lastWarmup = (warmup > 0xFFFF) ? 0xFFFF : (uint16_t)warmup;
+          if(_sample.samples == 1){
+              _sample.warmup = _sample.lastWarmup;
           }else{
-              interT1 = millis() - t1;
+              _sample.warmup = (uint16_t)((int32_t)_sample.warmup + ((int32_t)_sample.lastWarmup - (int32_t)_sample.warmup) / 4);
           }
-          t1 = millis();
-          val1 =val;
-          
       }
-      delay(5);
-      if((millis() - curT) > 1000){
-          break;
+  }else{
+      _sample.failures++;
+      // no frame in time: the sensor may just need longer, widen the estimate for the next sample.
+      // Only the uncalibrated marker proves that the sensor is up and waiting longer would not help.
+      if(_opPowered && !_opMarker){
+          _sample.warmup = (_sample.warmup + _sample.warmup / 2 > SAMPLE_WARMUP_MAX) ? SAMPLE_WARMUP_MAX :
+                           _sample.warmup + _sample.warmup / 2;
       }
   }
-  return false;
+  if(on > 0xFFFF) on = 0xFFFF;
+  _sample.onTime += on;
+  _sample.lastOnTime = (uint16_t)on;
+  if(on > _sample.maxOnTime) _sample.maxOnTime = (uint16_t)on;
+  if(!_session && _en > -1){
+      PIN_WRITE(_en, LOW);
+      _powered = false;
+      _off = true;
+      _offMs = now;
+  }
+}
+
+DFRobot_Nilometer::eOpState_t DFRobot_Nilometer::getOpState(){
+  return _opState;
+}
+
+DFRobot_Nilometer::eOpState_t DFRobot_Nilometer::step(){
+  DFRobot_SCW8916B_Parser::sEvent_t ev;
+  uint32_t now;
+  uint8_t val;
+  if(_opState != eOpBusy) return _opState;
+  now = millis();
+  switch(_opPhase){
+      case ePhasePowerOff:
+        if(!expired(_opDeadline)) break;
+        drainSerial();
+        PIN_WRITE(_en, HIGH);
+        _powered = true;
+        _enableMs = now;
+        _off = false;
+        _opPowered = true;
+        if(_op == eOpSample){
+            _opPhase = ePhaseWaitFrame;
+            _opStart = now;
+            _opDeadline = now + _opTimeout;
+        }else{
+            _opPhase = ePhaseSettle;
+            _opDeadline = now + POWER_SETTLE_TIME;
+        }
+        break;
+      case ePhaseSettle:
+        if(!expired(_opDeadline)) break;
+        if(_mode == eUARTDetecteMode){
+            sendCommand(_opCmd, _opLen, _opAck);
+            _opPhase = ePhaseWaitReply;
+            _opDeadline = now + _opTimeout;
+        }else{
+            if(_op == eOpSelfCheck) sendCommand(NULL, 0, 0);
+            PIN_WRITE(_test, LOW);
+            _opPhase = ePhaseTestPulse;
+            _opDeadline = now + ((_op == eOpSelfCheck) ? SELF_CHECK_IO_TIME : _opPulse);
+        }
+        break;
+      case ePhaseTestPulse:
+        if(!expired(_opDeadline)) break;
+        PIN_WRITE(_test, HIGH);
+        if(_op == eOpSelfCheck){
+            _opPhase = ePhaseWaitReply;
+            _opDeadline = now + _opTimeout;
+        }else{
+            _opPhase = ePhaseWatchOut;
+            _opStart = now;
+            DFRobot_SCW8916B_Protocol::calibStart(&_calibWatch, PIN_READ(_out), now);
+        }
+        break;
+      case ePhaseWaitReply:{
+        eOpState_t state = checkReply(_opDeadline, &ev);
+        if(state == eOpDone && ev.type == DFRobot_SCW8916B_Parser::eEventSelfCheck){
+            memcpy(&_rslt, ev.data, 2);
+        }
+        if(state != eOpBusy) finishOp(state);
+        break;
+      }
+      case ePhaseWatchOut:
+        if(DFRobot_SCW8916B_Protocol::calibUpdate(&_calibWatch, PIN_READ(_out), now, _opPulse)){
+            finishOp(eOpDone);
+            break;
+        }
+        if(now - _opStart > _opTimeout){
+            finishOp(eOpFailed);
+        }
+        break;
+      case ePhaseWaitFrame:
+        pump();
+        val = drainEvents();
+        if(val == DFRobot_SCW8916B_Parser::eEventDetect){
+            _calibrated = true;
+            if(_opVal == 0) _opT1 = now;
+            if(++_opVal >= SCW8916B_SAMPLE_FRAMES) finishOp(eOpDone);
+        }else if(val == DFRobot_SCW8916B_Parser::eEventUncalibrated){
+            _calibrated = false;
+            _opMarker = true;
+            finishOp(eOpFailed);
+        }else if(expired(_opDeadline)){
+            finishOp(eOpFailed);
+        }
+        break;
+  }
+  return _opState;
+}
+
+//正在进行下水位校准（空水箱校准），请不要触碰检测区域
+bool DFRobot_Nilometer::uartWaterLevelCalibration(int en, uint8_t cmd){
+  if(en < 0 || _s == NULL){
+      return false;
+  }
+  if(!startOp(eOpCalibration, &cmd, 1, DFRobot_SCW8916B_Protocol::calibrationAck(cmd), CALIB_TIMEOUT)){
+      return false;
+  }
+  return waitOp();
+}
+
+bool DFRobot_Nilometer::ioWaterLevelCalibration(int en, int test, uint8_t t){
+  if(en < 0 || test < 0 || _out < 0 || _opState == eOpBusy) return false;
+  _opPulse = t;
+  if(!startOp(eOpCalibration, NULL, 0, 0, CALIB_TIMEOUT)){
+      return false;
+  }
+  return waitOp();
 }
 
 uint8_t DFRobot_Nilometer::getCalibrationMode(){
@@ -198,60 +739,18 @@ bool DFRobot_Nilometer::uartSelfCheck(int en){
       return false;
   } 
   uint8_t cmd = SELF_CHECK_CMD;
-  int remain;
-  uint8_t buf[2] = {0};
-  enableSensor(en);
-  writeData(&cmd, 1);
-  delay(1000);
-  remain = _s->available();
-  if(remain >= 2){
-      buf[0] = _s->read();
-      DBG(buf[0],HEX);
-      for(int i = 0; i < remain - 1; i++){
-          buf[1] =  _s->read();
-          if(buf[0]+buf[1] == 0xFF){
-              memcpy(&_rslt, buf, 2);
-              DBG(_rslt.outs);
-              DBG(_rslt.value,HEX);
-              return true;
-          }
-          buf[0]=buf[1];
-      }
+  if(!startOp(eOpSelfCheck, &cmd, 1, 0, SELF_CHECK_UART_TIMEOUT)){
+      return false;
   }
-  return false;
+  return waitOp();
 }
 
 bool DFRobot_Nilometer::ioSelfCheck(int en, int test, Stream *s){
   if((en < 0) || (test < 0) ||(_out < 0) || s == NULL) return false;
-
-  uint8_t buf[2] = {0};
-  int remain;
-  pinMode(test, OUTPUT);
-  digitalWrite(test, HIGH);
-  enableSensor(en);
-  digitalWrite(test, LOW);
-  delay(500);
-  digitalWrite(test, HIGH);
-  delay(550);
-  delay(1000);
-  
-  remain = s->available();
-  if(remain >= 2){
-       buf[0] = s->read();
-       remain -= 1;
-       for(int i = 0; i < remain; i++){
-           buf[1] =  s->read();
-           delay(6);
-           //Serial.print("buf0 = ");Serial.println(buf[0],HEX);
-           //Serial.print("buf1 = ");Serial.println(buf[1],HEX);
-           if((buf[0] != 0 || buf[0] != 0xff) && (buf[0]+buf[1] == 0xFF)){
-              memcpy(&_rslt, buf, 2);
-              return true;
-           }
-           buf[0]=buf[1];
-       }
+  if(!startOp(eOpSelfCheck, NULL, 0, 0, SELF_CHECK_IO_TIMEOUT)){
+      return false;
   }
-  return false;
+  return waitOp();
 }
 
 String DFRobot_Nilometer::getCalibModeDescription(uint8_t mode){
@@ -275,20 +774,36 @@ void DFRobot_Nilometer::writeData(void *data, uint8_t len){
   _s->write(pBuf, len);
 }
 
-uint8_t DFRobot_Nilometer::readData(void *data, uint8_t len){
-  uint8_t *pBuf = (uint8_t *)data;
-  uint8_t size = 0;
-  uint8_t remain = _s->available();
-  uint8_t val = 0;
-  while(remain > len){
-      val = (uint8_t)_s->read();
-      remain--;
+int DFRobot_Nilometer::pump(){
+#if SCW8916B_ENABLE_HEALTH
+  uint32_t frames = _parser.framesDecoded();
+  uint32_t failures = _parser.checksumFailures();
+  int n = _parser.feed(_s);
+  if(n > 0){
+      _health.onBytes((uint16_t)(_parser.framesDecoded() - frames), (uint16_t)(_parser.checksumFailures() - failures));
   }
-  for(int i = 0; i < len; i++){
-      pBuf[size++] = _s->read();
+  return n;
+#else
+  return _parser.feed(_s);
+#endif
+}
+
+uint8_t DFRobot_Nilometer::drainEvents(){
+  uint8_t type = DFRobot_SCW8916B_Parser::eEventNone;
+  DFRobot_SCW8916B_Parser::sEvent_t ev;
+  while(_parser.pop(&ev)){
+      if(ev.type == DFRobot_SCW8916B_Parser::eEventDetect){
+          HEALTH_STATE(ev.data[0]);
+          _state = ev.data[0];
+          _stateValid = true;
+          _newState = true;
+          type = ev.type;
+      }else{
+          HEALTH_UNCALIBRATED();
+          if(type == DFRobot_SCW8916B_Parser::eEventNone) type = ev.type;
+      }
   }
-  DBG(size);
-  return size;
+  return type;
 }
 
 uint8_t DFRobot_Nilometer::getCs(void *data, uint8_t len){
@@ -304,24 +819,30 @@ uint8_t DFRobot_Nilometer::getCs(void *data, uint8_t len){
 void DFRobot_Nilometer::enableSensor(int en){
   if(en > -1){
       pinMode(en, OUTPUT);
-      digitalWrite(en, LOW);
-      delay(200);
-      if(_s != NULL){
-          while(_s->available()){
-              _s->read();
-          }
-      }
-      digitalWrite(en, HIGH);
-      delay(1000);
+      PIN_WRITE(en, LOW);
+      delay(POWER_OFF_TIME);
+      drainSerial();
+      PIN_WRITE(en, HIGH);
+      _powered = true;
+      _enableMs = millis();
+      _off = false;
+      delay(POWER_SETTLE_TIME);
   }
 }
-void DFRobot_Nilometer::flush(){
+void DFRobot_Nilometer::drainSerial(){
+  uint32_t n = 0;
   if(_s != NULL){
-      uint32_t  t= millis();
       while(_s->available()){
           _s->read();
+          n++;
       }
   }
+  _parser.discard(n);
+  _parser.reset();
+}
+
+void DFRobot_Nilometer::flush(){
+  pump();
 }
 
 uint8_t DFRobot_Nilometer::getSensitivity(){
@@ -332,41 +853,52 @@ uint8_t DFRobot_Nilometer::getSensitivity(){
 }
 
 bool DFRobot_Nilometer::checkCalibrationState(){
-  uCheckRslt_t rslt;
-  uint8_t val, val1;
-  int waitForTimeOutMs = 1000;
-  int waitForTimeoutIncMs = 100;
-  uint32_t t = 0;
+  uint8_t val, val1, type;
+  uint32_t deadline = millis() + 1000;
+  bool ret = false, timeout = false;
+  STATS_START();
   if(_mode == eUARTDetecteMode){
-      while((val1 = _s->read()) != ERR_CALIBRATION_CODE){
-          delay(waitForTimeoutIncMs);
-          t += waitForTimeoutIncMs;
-          memcpy(&rslt, &val1, 1);
-          if(rslt.value + rslt.pad == 0x0f) return true;
-          if(t > waitForTimeOutMs){
-              return true;
+      while(1){
+          pump();
+          type = drainEvents();
+          if(type == DFRobot_SCW8916B_Parser::eEventDetect){
+              _calibrated = true;
+              ret = true;
+              break;
+          }
+          if(type == DFRobot_SCW8916B_Parser::eEventUncalibrated){
+              _calibrated = false;
+              break;
           }
+          if(expired(deadline)){
+              ret = timeout = true;
+              break;
+          }
+          delay(1);
       }
   }else{
-      val = digitalRead(_out);
-      while((val1 = digitalRead(_out)) == val){
-          delay(waitForTimeoutIncMs);
-          t += waitForTimeoutIncMs;
-          if(t > waitForTimeOutMs){
-              return true;
-          } 
+      val = PIN_READ(_out);
+      while((val1 = PIN_READ(_out)) == val){
+          if(expired(deadline)){
+              ret = timeout = true;
+              break;
+          }
+          delay(1);
       }
       val = val1;
-      for(int i = 0; i < 5; i++){
+      for(int i = 0; i < 5 && !timeout; i++){
           delay(100);
-          val1 = digitalRead(_out);
+          val1 = PIN_READ(_out);
           if(val + val1 != 1){
-              return true;
+              ret = true;
+              break;
           }
           val = val1;
       }
   }
-  return false;
+  STATS_RECORD(eStatCheckCalibration, timeout);
+  HEALTH_COMMAND(!timeout);
+  return ret;
 }
 
 DFRobot_SCW8916B_IO::DFRobot_SCW8916B_IO(int out, int en, int test, Stream *s)
@@ -379,27 +911,145 @@ bool DFRobot_SCW8916B_UART::setSensitivityLevel(eSensitivityLevel_t level){
   return setSensitivityLevel((uint8_t) level);
 }
 
+bool DFRobot_SCW8916B_UART::startSetSensitivityLevel(uint8_t level){
+  uint8_t levels[4] = {level, 7, 7, 7};
+  return startSetSensitivityLevels(levels);
+}
+
+bool DFRobot_SCW8916B_UART::startSetSensitivityLevels(const uint8_t levels[4]){
+  uint8_t buf[SENSITIVITY_FRAME_LEN];
+  if(_mode != eUARTDetecteMode || _s == NULL || _opState == eOpBusy) return false;
+  DFRobot_SCW8916B_Protocol::sensitivityFrame(levels, buf);
+  memcpy(_senPending, buf + 1, sizeof(_senPending));
+  return startOp(eOpSensitivity, buf, sizeof(buf), SENSITIVITY_ACK, SENSITIVITY_TIMEOUT);
+}
+
 bool DFRobot_SCW8916B_UART::setSensitivityLevel(uint8_t level){
-  uint8_t buf[6] = {0x43, (uint8_t)(level&0x07), 7,7,7};
-  uint8_t state = 0x53;
-  int waitForTimeOutMs = 2000;
-  int waitForTimeoutIncMs = 100;
-  int t = 0;
-  uint8_t val;
-  if(_mode == eUARTDetecteMode){
-      buf[5] = getCs(buf+1, 4);
-      enableSensor(_en);
+  if(!startSetSensitivityLevel(level)){
+      return false;
+  }
+  return waitOp();
+}
 
-      writeData(buf, sizeof(buf));
-      while(1){
-          val = _s->read();
-          if(state == val){
-              flush();
-              return true;
-          }
-          delay(waitForTimeoutIncMs);
-          t += waitForTimeoutIncMs;
-          if(t > waitForTimeOutMs) return false;
+bool DFRobot_SCW8916B_UART::setSensitivityLevels(const uint8_t levels[4]){
+  bool session = _session;
+  bool ret = false;
+  if(_en < 0) return false;
+  if(!session) _powered = false;   // outside a session every call power cycles the sensor once
+  _session = true;
+  if(startSetSensitivityLevels(levels) && waitOp()){
+      ret = uartSelfCheck(_en) && (_rslt.sen == (levels[0] & 0x07));
+  }
+  _session = session;
+  return ret;
+}
+
+uint8_t DFRobot_SCW8916B_UART::getSensitivity(uint8_t channel){
+  if(channel == 1) return DFRobot_Nilometer::getSensitivity();
+  if(channel < 1 || channel > 4) return 0xFF;
+  return _senLevels[channel - 1];
+}
+
+void DFRobot_SCW8916B_UART::resetTune(sTuneRslt_t *rslt){
+  rslt->emptyMin = 8;
+  rslt->fullMax = TUNE_LEVEL_NONE;
+  rslt->level = TUNE_LEVEL_NONE;
+  rslt->steps = 0;
+  memset(rslt->reading, 0, sizeof(rslt->reading));
+}
+
+uint8_t DFRobot_SCW8916B_UART::probeLevel(uint8_t level){
+  uint8_t levels[4];
+  uint8_t skip = SCW8916B_TUNE_SKIP_FRAMES;
+  uint32_t deadline;
+  levels[0] = level;
+  for(uint8_t i = 1; i < 4; i++){
+      levels[i] = (_senLevels[i] == 0xFF) ? 7 : _senLevels[i];
+  }
+  if(!startSetSensitivityLevels(levels) || !waitOp()) return ERR_CHANNELS_CODE;
+  pump();
+  drainEvents();
+  deadline = millis() + 1000;
+  while(!expired(deadline)){
+      pump();
+      if(drainEvents() == DFRobot_SCW8916B_Parser::eEventDetect){
+          if(skip == 0) return _state;
+          skip--;
+      }
+      delay(1);
+  }
+  return ERR_CHANNELS_CODE;
+}
+
+bool DFRobot_SCW8916B_UART::tuneSensitivity(bool water, sTuneRslt_t *rslt){
+  bool session = _session;
+  uint8_t lo = 0, hi = 8, mid, mask;
+  bool ret = true;
+  if(_mode != eUARTDetecteMode || _en < 0 || _s == NULL) return false;
+  if(!session) _powered = false;
+  _session = true;
+  // Find the lowest level which reads no water, every level above it reads no water too.
+  while(lo < hi){
+      mid = (lo + hi) / 2;
+      mask = probeLevel(mid);
+      if(mask == ERR_CHANNELS_CODE){
+          ret = false;
+          break;
+      }
+      rslt->steps++;
+      rslt->reading[mid] |= water ? TUNE_PROBED_FULL : TUNE_PROBED_EMPTY;
+      if(mask & WATER_CHANNEL_1){
+          rslt->reading[mid] |= water ? TUNE_WET_FULL : TUNE_WET_EMPTY;
+          lo = mid + 1;
+      }else{
+          hi = mid;
       }
   }
-}
\ No newline at end of file
+  if(ret){
+      if(water){
+          rslt->fullMax = lo ? lo - 1 : TUNE_LEVEL_NONE;
+      }else{
+          rslt->emptyMin = lo;
+      }
+  }
+  _session = session;
+  return ret;
+}
+
+uint8_t DFRobot_SCW8916B_UART::applyTune(sTuneRslt_t *rslt){
+  rslt->level = TUNE_LEVEL_NONE;
+  if(rslt->fullMax == TUNE_LEVEL_NONE || rslt->emptyMin > 7 || rslt->fullMax < rslt->emptyMin){
+      return TUNE_LEVEL_NONE;
+  }
+  uint8_t level = (rslt->emptyMin + rslt->fullMax + 1) / 2;
+  uint8_t levels[4] = {level};
+  for(uint8_t i = 1; i < 4; i++){
+      levels[i] = (_senLevels[i] == 0xFF) ? 7 : _senLevels[i];
+  }
+  if(!setSensitivityLevels(levels)) return TUNE_LEVEL_NONE;
+  rslt->level = level;
+  return level;
+}
+
+bool DFRobot_SCW8916B_UART::startSample(){
+  uint32_t timeout = 2 * (uint32_t)_sample.warmup + SAMPLE_FRAME_MARGIN;
+  if(_mode != eUARTDetecteMode || _s == NULL || _en < 0) return false;
+  return startOp(eOpSample, NULL, 0, 0, (uint16_t)timeout);
+}
+
+bool DFRobot_SCW8916B_UART::sample(){
+  if(!startSample()){
+      return false;
+  }
+  return waitOp();
+}
+
+const DFRobot_Nilometer::sSampleStats_t *DFRobot_SCW8916B_UART::getSampleStats(){
+  return &_sample;
+}
+
+void DFRobot_SCW8916B_UART::resetSampleStats(){
+  uint16_t warmup = _sample.warmup;
+  memset(&_sample, 0, sizeof(_sample));
+  _sample.warmup = warmup;
+}
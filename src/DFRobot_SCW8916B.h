@@ -31,6 +31,12 @@
 #endif
 
 #include<Stream.h>
+#include "DFRobot_SCW8916B_Parser.h"
+#include "DFRobot_SCW8916B_Protocol.h"
+#include "DFRobot_SCW8916B_Store.h"
+#include "DFRobot_SCW8916B_Stats.h"
+#include "DFRobot_SCW8916B_Trace.h"
+#include "DFRobot_SCW8916B_Health.h"
 
 //Define DBG, change 0 to 1 open the DBG, 1 to 0 to close.  
 #if 0
@@ -40,18 +46,48 @@
 #endif
 
 
+#ifndef SCW8916B_EDGE_QUEUE_SIZE
+#define SCW8916B_EDGE_QUEUE_SIZE       16   /**<Capacity of the OUT edge queue, a power of 2, at most 128*/
+#endif
+static_assert((SCW8916B_EDGE_QUEUE_SIZE > 0) && ((SCW8916B_EDGE_QUEUE_SIZE & (SCW8916B_EDGE_QUEUE_SIZE - 1)) == 0) &&
+              (SCW8916B_EDGE_QUEUE_SIZE <= 128),
+              "SCW8916B_EDGE_QUEUE_SIZE must be a power of 2 and at most 128, the 8-bit queue indexes wrap around it");
+#define SCW8916B_EDGE_CAPTURE_SLOTS    4    /**<Max number of sensors which capture OUT edges at the same time*/
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+//Orders the edge records against the queue head, the ISR and the loop may run on different cores(ESP32).
+#if defined(ESP32)
+#define SCW8916B_EDGE_BARRIER()   __sync_synchronize()
+#else
+#define SCW8916B_EDGE_BARRIER()   __asm__ __volatile__("" ::: "memory")
+#endif
+
+#ifndef SCW8916B_DISCOVERY_BUDGET
+#define SCW8916B_DISCOVERY_BUDGET      8000 /**<Default time budget of begin, unit: ms*/
+#endif
+#ifndef SCW8916B_SAMPLE_FRAMES
+#define SCW8916B_SAMPLE_FRAMES         1    /**<Valid detection frames which are read by a duty-cycled sample, the last one is the reading*/
+#endif
+#define SAMPLE_WARMUP_INIT             POWER_SETTLE_TIME /**<Warm-up estimate before the first sample, unit: ms*/
+#define SAMPLE_WARMUP_MAX              4000 /**<Upper limit of the warm-up estimate, unit: ms*/
+#define SAMPLE_FRAME_MARGIN            200  /**<A sample waits twice the warm-up estimate plus this time for its frames, unit: ms*/
+
 #define CALIBRATION_MODE_LOWER_LEVEL   0/**<Only calibrate the lower water level*/
 #define CALIBRATION_MODE_LOWER_AND_UPPER_LEVEL   1 /**<Calibrate the upper and lower water levels*/
 
 class DFRobot_Nilometer{
 private:
-#define SELF_CHECK_CMD          0x34
-#define CALIB_UART_CMD_LWL      0x25
-#define CALIB_UART_CMD_UWL      0x8A
-#define CALIB_IO_TIME_LWL       100   /**<unit: ms*/
-#define CALIB_IO_TIME_UWL       200   /**<unit: ms*/
+#define SNAPSHOT_MAGIC          0x5C
 public:
 #define ERR_CALIBRATION_CODE    0xAA
+#define ERR_CHANNELS_CODE       0xFF   /**<No valid frame, returned by detectWaterChannels*/
+#define WATER_CHANNEL_1         0x01   /**<Water state bit of channel 1*/
+#define WATER_CHANNEL_2         0x02   /**<Water state bit of channel 2*/
+#define WATER_CHANNEL_3         0x04   /**<Water state bit of channel 3*/
+#define WATER_CHANNEL_4         0x08   /**<Water state bit of channel 4*/
 typedef enum{
   eLevelDetecteMode = 0,/**<level one-to-one detection mode*/
   eUARTDetecteMode/**<UART detecte mode.*/
@@ -91,6 +127,23 @@ typedef union{
   };
   uint8_t value:4; /**<One's complement of the first 4 bits*/
 }uCheckRslt_t;
+
+typedef enum{
+  eOpIdle = 0,  /**<No asynchronous operation has been started*/
+  eOpBusy,      /**<The operation is running, call step again*/
+  eOpDone,      /**<The operation succeeded*/
+  eOpFailed     /**<The operation failed or timed out*/
+}eOpState_t;
+
+typedef struct{
+  uint32_t samples;      /**<Successful samples*/
+  uint32_t failures;     /**<Samples which got no valid frame before the timeout, or the uncalibrated marker*/
+  uint32_t onTime;       /**<Total time which the sensor was powered for samples, unit: ms*/
+  uint16_t lastOnTime;   /**<Powered time of the last sample, unit: ms*/
+  uint16_t maxOnTime;    /**<Longest powered time of a sample, unit: ms*/
+  uint16_t warmup;       /**<Moving average of the time from power on to the first valid frame, unit: ms*/
+  uint16_t lastWarmup;   /**<Warm-up time of the last successful sample, unit: ms*/
+}sSampleStats_t;
 /**
  * @brief DFRobot_Nilometer abstract class constructor. Construct serial port detection object.(eUARTDetecteMode)
  * @param s:  The class pointer object of Abstract class， here you can fill in the pointer to the serial port object
@@ -105,15 +158,29 @@ typedef union{
  * @param s:  The class pointer object of Abstract class， here you can fill in the pointer to the serial port object
  */
   DFRobot_Nilometer(int out, int en, int test, Stream *s);//eLevelDetecteMode
+/**
+ * @brief Not virtual(no vtable on small MCUs), delete a sensor through DFRobot_SCW8916B_UART or DFRobot_SCW8916B_IO.
+ */
   ~DFRobot_Nilometer();
 /**
- * @brief liquide level sensor initialization.
+ * @brief liquide level sensor initialization, it returns as soon as the calibration state of the sensor is known.
+ * @n In UART detected mode, every buffered byte is scanned at once, the first valid detection frame proves the sensor
+ * @n is calibrated, and the uncalibrated marker(0xAA) is recognized immediately, so a healthy sensor is confirmed
+ * @n within one frame period.
+ * @n In level one-to-one detection mode, an uncalibrated sensor toggles OUT every 100ms, it is recognized after
+ * @n UNCALIB_TOGGLES toggles in a row, a stable OUT pin is accepted when the budget is used up.
+ * @param budget  The startup time budget, unit: ms. When it is used up without a proof, the sensor is regarded as calibrated.
  * @return initialization state:
  * @n      0:  sucess
  * @n      0xAA(170)：代表传感器从来没有校准过，需要先对传感器进行校准（UART）
  * @n      -1:  fail
  */
-  int begin();
+  int begin(uint16_t budget = SCW8916B_DISCOVERY_BUDGET);
+/**
+ * @brief Get how long the last begin took.
+ * @return The discovery time, unit: ms.
+ */
+  uint32_t getDiscoveryTime();
 /**
  * @brief Detect the presence or absence of water.
  * @return water state:
@@ -121,6 +188,83 @@ typedef union{
            false: There is no water at this location.
  */
   bool detectWater();
+/**
+ * @brief Detect the presence or absence of water on all channels, every channel is decoded from the same valid frame.
+ * @n In level one-to-one detection mode, only channel 1 is available.
+ * @return water state mask:
+ * @n      bit0(WATER_CHANNEL_1) ~ bit3(WATER_CHANNEL_4): 1: There is water on the channel, 0: There is no water on the channel.
+ * @n      0xFF(ERR_CHANNELS_CODE): No valid frame was received.
+ */
+  uint8_t detectWaterChannels();
+/**
+ * @brief Non-blocking detection. Consume every frame byte which has been buffered by the serial port(UART) or 
+ * @n sample the OUT pin once(level one-to-one detection), and return immediately.
+ * @n In UART detected mode, every valid frame is a new state. In level one-to-one detection mode, a new state is 
+ * @n reported when the level of OUT pin changes.
+ * @return new state flag:
+ * @n      true:  A new water state arrived, you can call lastState to get it.
+ * @n      false: No new water state.
+ */
+  bool poll();
+/**
+ * @brief Whether there is a water state which has been received by poll, but not read by lastState.
+ * @return available state:
+ * @n      true:  There is a new water state.
+ * @n      false: There is no new water state.
+ */
+  bool available();
+/**
+ * @brief Get the latest water state which is received by poll, and clear the available flag.
+ * @return water state:
+           true: There is water at this location.
+           false: There is no water at this location, or poll has never received a valid state.
+ */
+  bool lastState();
+/**
+ * @brief Get the water state of all channels which is received by poll, and clear the available flag.
+ * @return water state mask:
+ * @n      bit0(WATER_CHANNEL_1) ~ bit3(WATER_CHANNEL_4): 1: There is water on the channel, 0: There is no water on the channel.
+ * @n      0xFF(ERR_CHANNELS_CODE): poll has never received a valid state.
+ */
+  uint8_t lastChannels();
+/**
+ * @brief Non-blocking detection with a level of the OUT pin which is sampled by the caller, only use in level 
+ * @n one-to-one detection mode. DFRobot_SCW8916B_IOBank samples the OUT pins of many sensors by one port read 
+ * @n and passes every level here.
+ * @param level  The level of the OUT pin, 0: no water, other: have water.
+ * @return new state flag, the same as poll.
+ */
+  bool pollLevel(uint8_t level);
+/**
+ * @brief Get the OUT pin of the sensor.
+ * @return The OUT pin, -1: not connected or UART detected mode.
+ */
+  int getOutPin();
+/**
+ * @brief Capture the edges of the OUT pin by interrupt, only use in level one-to-one detection mode.
+ * @n The interrupt pushes every edge(timestamp, level) into a lock-free single-producer/single-consumer queue,
+ * @n poll takes the edges from the queue instead of sampling the OUT pin, so short transitions are not missed.
+ * @n The OUT pin must support external interrupt, at most SCW8916B_EDGE_CAPTURE_SLOTS sensors at the same time.
+ * @return enable state:
+ * @n      true:  Edge capture is enabled.
+ * @n      false: Not level one-to-one detection mode, the OUT pin has no interrupt, or no free slot.
+ */
+  bool enableEdgeCapture();
+/**
+ * @brief Stop capturing the edges of the OUT pin, poll samples the OUT pin again.
+ */
+  void disableEdgeCapture();
+/**
+ * @brief Take the oldest captured edge. poll takes the edges too, call popEdge before poll if you need every edge.
+ * @param t      The time of the edge, unit: ms(millis()).
+ * @param level  The level of the OUT pin after the edge, 1: have water, 0: no water.
+ * @return true: an edge is taken, false: the queue is empty.
+ */
+  bool popEdge(uint32_t *t, uint8_t *level);
+/**
+ * @brief The number of edges which are lost because the queue was full.
+ */
+  uint32_t getEdgeOverflows();
 /**
  * @brief Self check which can update to get the current sensitivity and calibration mode.
  * @n In UART detected mode: You must use TX, RX and EN pin of sensor.
@@ -140,6 +284,37 @@ typedef union{
  * @n      false: Calibration fail.
  */
   bool calibration();
+
+/**
+ * @brief Start an asynchronous self check, then call step until it returns eOpDone or eOpFailed.
+ * @n The pins which are required are the same as selfCheck.
+ * @return start state:
+ * @n      true:  The operation is started.
+ * @n      false: The required pins are not configured, or another operation is running.
+ */
+  bool startSelfCheck();
+/**
+ * @brief Start an asynchronous lower water level calibration, then call step until it returns eOpDone or eOpFailed.
+ * @n The pins which are required are the same as calibration.
+ * @return start state:
+ * @n      true:  The operation is started.
+ * @n      false: The required pins are not configured, or another operation is running.
+ */
+  bool startCalibration();
+/**
+ * @brief Advance the asynchronous operation, never blocks. All waits are driven by millis() deadlines.
+ * @return operation state:
+ * @n      eOpIdle:   No operation has been started.
+ * @n      eOpBusy:   The operation is running.
+ * @n      eOpDone:   The operation succeeded, after a self check getSensitivity and getCalibrationMode are updated.
+ * @n      eOpFailed: The operation failed.
+ */
+  eOpState_t step();
+/**
+ * @brief Get the state of the asynchronous operation without advancing it.
+ * @return operation state, the same as step.
+ */
+  eOpState_t getOpState();
   
 /**
  * @brief Get calibration mode of sensor.
@@ -176,6 +351,7 @@ typedef union{
   uint8_t getSensitivity();
 /**
  * @brief Clear recive buffer of UART, only use in UART deteceted mode.
+ * @n The bytes are passed through the frame parser first, so the valid frames are still available to poll.
  */
   void flush();
 /**
@@ -186,7 +362,160 @@ typedef union{
  * @n      false: calibration failed.
  */
   bool checkCalibrationState();
+/**
+ * @brief Start a configuration session. The first operation of the session power cycles the sensor through EN,
+ * @n the following selfCheck and setSensitivityLevel in UART detected mode share that power cycle, they only wait
+ * @n until the sensor has been powered for 1s, so a batch of operations costs one power cycle instead of one each.
+ * @n calibration and the operations of level one-to-one detection mode always power cycle the sensor.
+ * @n A failed operation ends the shared power cycle, the next operation power cycles the sensor again.
+ */
+  void beginSession();
+/**
+ * @brief End the configuration session, every operation power cycles the sensor again.
+ */
+  void endSession();
+/**
+ * @brief Whether a configuration session is open.
+ */
+  bool inSession();
+/**
+ * @brief Get the time when the sensor was powered on through EN by the library.
+ * @return millis() of the last power on, 0 if the library has never powered on the sensor.
+ */
+  uint32_t getEnableTime();
+/**
+ * @brief Set the persistent store of the snapshot. When a store is set, every successful selfCheck and calibration
+ * @n saves the self-check result and the calibration state to it.
+ * @param store  The store, for example DFRobot_SCW8916B_EEPROMStore, NULL: no store.
+ */
+  void setStore(DFRobot_SCW8916B_Store *store);
+/**
+ * @brief Save the last validated self-check result and the calibration state to the store.
+ * @return true: saved, false: no store, no validated self-check result, or write fail.
+ */
+  bool saveSnapshot();
+/**
+ * @brief Restore the self-check result and the calibration state from the store, the snapshot is checked by checksum.
+ * @n After it, getSensitivity and getCalibrationMode return the stored values without selfCheck.
+ * @return true: restored, false: no store, nothing is stored or checksum error.
+ */
+  bool restoreSnapshot();
+/**
+ * @brief liquide level sensor initialization from the snapshot. The snapshot is restored and confirmed with a single
+ * @n valid detection frame(UART) or a single sample of the OUT pin(level one-to-one detection mode).
+ * @n If there is no valid snapshot, or no frame arrives before timeout, it falls back to begin.
+ * @param timeout  The time to wait for the detection frame, unit: ms.
+ * @return initialization state, the same as begin:
+ * @n      0:  sucess
+ * @n      0xAA(170)：代表传感器从来没有校准过，需要先对传感器进行校准（UART）
+ * @n      -1:  fail
+ */
+  int warmBegin(uint16_t timeout = 1000);
+#if SCW8916B_ENABLE_STATS
+/**
+ * @brief Get the statistics, only available when SCW8916B_ENABLE_STATS is 1.
+ * @n The frame and byte counters come from the frame parser, every public operation has the number of calls,
+ * @n timeouts and retries and a latency histogram, indexed by eStatOp_t.
+ * @return The statistics, they are valid until the next call of the library.
+ */
+  const sSCW8916BStats_t *getStats();
+/**
+ * @brief Clear the statistics, only available when SCW8916B_ENABLE_STATS is 1.
+ */
+  void resetStats();
+#endif
+#if SCW8916B_ENABLE_TRACE
+/**
+ * @brief Record the traffic with the sensor into a trace, only available when SCW8916B_ENABLE_TRACE is 1.
+ * @n The serial port is wrapped by a DFRobot_SCW8916B_TraceStream, the pins are recorded by the library,
+ * @n except the OUT levels which are captured by the edge capture interrupt.
+ * @param trace  The trace, NULL stops recording.
+ */
+  void setTrace(DFRobot_SCW8916B_Trace *trace);
+#endif
+#if SCW8916B_ENABLE_HEALTH
+/**
+ * @brief Get the health of the sensor, only available when SCW8916B_ENABLE_HEALTH is 1(DFRobot_SCW8916B_Health.h).
+ * @n It is updated by the frames and OUT samples which poll, detectWater and the other calls already read, and by
+ * @n the result of every command, so it costs no extra traffic.
+ * @return The health: state(eHealthState_t), reasons(eHealthReason_t mask) and the rolling values, they are valid
+ * @n until the next call of the library.
+ */
+  const sSCW8916BHealth_t *getHealth();
+/**
+ * @brief Forget the health, only available when SCW8916B_ENABLE_HEALTH is 1.
+ */
+  void resetHealth();
+/**
+ * @brief Set the limits of the health, only available when SCW8916B_ENABLE_HEALTH is 1.
+ * @param silentMs  Failed when no valid frame or OUT sample is read for this time, unit: ms, 0: off.
+ * @param stuckMs   Degraded when the water state does not change for this time, unit: ms, 0: off.
+ */
+  void setHealthLimits(uint32_t silentMs, uint32_t stuckMs);
+#endif
 protected:
+typedef enum{
+  eOpNone = 0,
+  eOpSelfCheck,
+  eOpCalibration,
+  eOpSensitivity,
+  eOpSample
+}eOpType_t;
+
+typedef enum{
+  ePhasePowerOff = 0, /**<EN is held low*/
+  ePhaseSettle,       /**<EN is high, wait for the sensor to start*/
+  ePhaseTestPulse,    /**<TEST is held low(level one-to-one detection mode)*/
+  ePhaseWaitReply,    /**<Wait for the self-check pair or the ack*/
+  ePhaseWatchOut,     /**<Watch the OUT pin for the calibration pattern(level one-to-one detection mode)*/
+  ePhaseWaitFrame     /**<Wait for the valid detection frames of a duty-cycled sample*/
+}eOpPhase_t;
+
+/**
+ * @brief Start an asynchronous operation.
+ * @param op       The operation.
+ * @param cmd      The command which is sent in UART detected mode, NULL if none.
+ * @param len      The length of the command.
+ * @param ack      The expected ack byte, 0 if a self-check pair is expected.
+ * @param timeout  The reply timeout after the command is sent, unit: ms.
+ * @return true: started, false: another operation is running.
+ */
+  bool startOp(eOpType_t op, const uint8_t *cmd, uint8_t len, uint8_t ack, uint16_t timeout);
+/**
+ * @brief Whether the operation can use the power cycle of the session instead of its own.
+ */
+  bool sharePower(eOpType_t op);
+  void finishOp(eOpState_t state);
+/**
+ * @brief End a duty-cycled sample: update the statistics and the warm-up estimate, power the sensor down
+ * @n unless a configuration session is open.
+ */
+  void finishSample(eOpState_t state);
+/**
+ * @brief Run the asynchronous operation which has been started to the end.
+ * @return true: eOpDone, false: eOpFailed.
+ */
+  bool waitOp();
+/**
+ * @brief Whether an absolute millis() deadline has passed, it is safe across the overflow of millis().
+ */
+  static bool expired(uint32_t deadline);
+/**
+ * @brief Command/response primitive, the first half: arm the parser for the reply and send the command.
+ * @param cmd  The command, NULL if nothing is sent(the reply is triggered by the TEST pin).
+ * @param len  The length of the command.
+ * @param ack  The expected ack byte, 0 if a self-check pair is expected.
+ */
+  void sendCommand(const void *cmd, uint8_t len, uint8_t ack);
+/**
+ * @brief Command/response primitive, the second half: check for the reply, never blocks. Every command path
+ * @n (selfCheck, calibration, setSensitivityLevel and their start* versions) waits here in ePhaseWaitReply of step,
+ * @n the blocking calls run step through waitOp.
+ * @param deadline  The absolute millis() deadline of the reply.
+ * @param ev        The reply.
+ * @return eOpDone: the reply arrived, eOpFailed: the deadline has passed, eOpBusy: keep waiting.
+ */
+  eOpState_t checkReply(uint32_t deadline, DFRobot_SCW8916B_Parser::sEvent_t *ev);
 /**
  * @brief Water level calibration in UART Mode.
  * @param en  The IO pin of MCU which is connected to the EN pin of Non-contact liquid level sensor.
@@ -215,7 +544,24 @@ protected:
   uint8_t getCs(void *data, uint8_t len);
   void enableSensor(int en);
   void writeData(void *data, uint8_t len);
-  uint8_t readData(void *data, uint8_t len);
+/**
+ * @brief Pass every byte which is buffered by the serial port to the frame parser.
+ * @return The number of bytes consumed.
+ */
+  int pump();
+/**
+ * @brief Throw away every byte which is buffered by the serial port and reset the frame parser before the sensor
+ * @n is powered on, the bytes are counted as discarded.
+ */
+  void drainSerial();
+/**
+ * @brief Take the detection events of the frame parser and update the water state.
+ * @return event type:
+ * @n      eEventDetect:       At least one detection frame was taken.
+ * @n      eEventUncalibrated: Only the uncalibrated marker was taken.
+ * @n      eEventNone:         The queue is empty.
+ */
+  uint8_t drainEvents();
 
   Stream *_s;
   int _out;
@@ -223,6 +569,77 @@ protected:
   int _en;
   eDetecteMode_t _mode;
   sSelfCheckRslt_t _rslt;
+  uint8_t _state;      /**<The latest water state mask received by poll, bit0~bit3: channel 1~4*/
+  bool _stateValid;    /**<_state has been received at least once*/
+  bool _newState;      /**<_state has not been read by lastState*/
+  DFRobot_SCW8916B_Parser _parser;
+
+  eOpType_t _op;
+  eOpPhase_t _opPhase;
+  eOpState_t _opState;
+  uint32_t _opDeadline;
+  uint32_t _opStart;
+  uint32_t _opT1;
+  DFRobot_SCW8916B_Protocol::sCalibWatch_t _calibWatch;
+  uint16_t _opTimeout;
+  uint8_t _opPulse;
+  uint8_t _opVal;
+  uint8_t _opAck;
+  uint8_t _opCmd[6];
+  uint8_t _opLen;
+  uint8_t _senPending[4];    /**<The sensitivity levels of the running eOpSensitivity*/
+  uint8_t _senLevels[4];     /**<The sensitivity levels which are acked by the sensor, 0xFF: unknown*/
+
+typedef struct{
+  uint8_t magic;       /**<SNAPSHOT_MAGIC*/
+  uint8_t value;       /**<sSelfCheckRslt_t value*/
+  uint8_t pad;         /**<sSelfCheckRslt_t pad*/
+  uint8_t calibrated;  /**<1: the sensor has been calibrated*/
+  uint8_t cs;          /**<The one's complement of the sum of the previous bytes*/
+}sSnapshot_t;
+
+  DFRobot_SCW8916B_Store *_store;
+  bool _calibrated;          /**<A detection frame or a calibration has proved the sensor is calibrated*/
+  uint32_t _discoveryTime;   /**<Duration of the last begin, unit: ms*/
+#if SCW8916B_ENABLE_STATS
+  DFRobot_SCW8916B_Stats _stats;
+  uint32_t _opStartUs;       /**<micros() when the asynchronous operation was started*/
+#endif
+#if SCW8916B_ENABLE_TRACE
+  int tracePinRead(int pin);
+  void tracePinWrite(int pin, uint8_t val);
+  DFRobot_SCW8916B_Trace *_trace;
+  DFRobot_SCW8916B_TraceStream _traceStream;
+#endif
+#if SCW8916B_ENABLE_HEALTH
+  DFRobot_SCW8916B_Health _health;
+#endif
+  bool _session;             /**<A configuration session is open*/
+  bool _powered;             /**<The sensor has been powered on by the library, and the last operation succeeded*/
+  uint32_t _enableMs;        /**<millis() when EN was driven high by the library*/
+  uint32_t _offMs;           /**<millis() when EN was driven low by the last sample*/
+  bool _off;                 /**<EN has been held low since _offMs*/
+  bool _opPowered;           /**<The running operation powered the sensor on itself*/
+  bool _opMarker;            /**<The running sample received the uncalibrated marker*/
+  sSampleStats_t _sample;
+
+typedef struct{
+  uint32_t t;
+  uint8_t level;
+}sEdge_t;
+
+  void onEdge();
+  static void edgeIsr0();
+  static void edgeIsr1();
+  static void edgeIsr2();
+  static void edgeIsr3();
+  static DFRobot_Nilometer *_edgeSlot[SCW8916B_EDGE_CAPTURE_SLOTS];
+
+  int8_t _edgeSlotIndex;   /**<Index of the slot which is used by this sensor, -1: edge capture is disabled*/
+  sEdge_t _edge[SCW8916B_EDGE_QUEUE_SIZE];
+  volatile uint8_t _edgeHead;
+  volatile uint8_t _edgeTail;
+  volatile uint32_t _edgeOverflows;
   
 };
 
@@ -240,8 +657,25 @@ public:
   DFRobot_SCW8916B_IO(int out, int en = -1, int test = -1, Stream *s = NULL);
 };
 
+#ifndef SCW8916B_TUNE_SKIP_FRAMES
+#define SCW8916B_TUNE_SKIP_FRAMES   1     /**<Detection frames which are skipped after a sensitivity change during auto-tune*/
+#endif
+#define TUNE_LEVEL_NONE             0xFF  /**<No level is found by auto-tune*/
+#define TUNE_PROBED_EMPTY           0x01  /**<sTuneRslt_t reading: the level is probed with the empty tank*/
+#define TUNE_WET_EMPTY              0x02  /**<sTuneRslt_t reading: the level reads water with the empty tank*/
+#define TUNE_PROBED_FULL            0x04  /**<sTuneRslt_t reading: the level is probed with the full tank*/
+#define TUNE_WET_FULL               0x08  /**<sTuneRslt_t reading: the level reads water with the full tank*/
+
 class DFRobot_SCW8916B_UART: public DFRobot_Nilometer{
 public:
+typedef struct{
+  uint8_t emptyMin;    /**<The lowest level which reads no water with the empty tank, 8: none*/
+  uint8_t fullMax;     /**<The highest level which reads water with the full tank, TUNE_LEVEL_NONE: none*/
+  uint8_t level;       /**<The level which is chosen by applyTune, TUNE_LEVEL_NONE: no level separates empty and full*/
+  uint8_t steps;       /**<The number of levels which are probed*/
+  uint8_t reading[8];  /**<The readings of level 0~7, TUNE_PROBED_EMPTY | TUNE_WET_EMPTY | TUNE_PROBED_FULL | TUNE_WET_FULL*/
+}sTuneRslt_t;
+
 /**
  * @brief DFRobot_SCW8916B_UART abstract class constructor. Construct serial port detection object.(eUARTDetecteMode)
  * @param s:  The class pointer object of Abstract class， here you can fill in the pointer to the serial port object
@@ -268,5 +702,91 @@ public:
  */
   bool setSensitivityLevel(eSensitivityLevel_t level);
   bool setSensitivityLevel(uint8_t level);
+/**
+ * @brief Start an asynchronous setting of the sensitivity level, then call step until it returns eOpDone or eOpFailed.
+ * @param level:   the enum varible of eSensitivityLevel_t or 0~7
+ * @return start state:
+ * @n      true:  The operation is started.
+ * @n      false: Another operation is running.
+ */
+  bool startSetSensitivityLevel(uint8_t level);
+/**
+ * @brief Set the sensitivity levels of all channels in one frame and one power cycle, then confirm them with a single
+ * @n self check in the same power cycle. The self check only reports the level of channel 1, the levels of channel 2~4
+ * @n are confirmed by the ack of the sensor and cached, getSensitivity(channel) returns them.
+ * @param levels  The sensitivity levels of channel 1~4, 0~7 or eSensitivityLevel0~eSensitivityLevel7.
+ * @return status: return config state.
+ * @n      true:  Set sensitivity sucess, and the self check reads back the level of channel 1.
+ * @n      false:  Set sensitivity fail.
+ */
+  bool setSensitivityLevels(const uint8_t levels[4]);
+/**
+ * @brief Start an asynchronous setting of the sensitivity levels of all channels, then call step until it returns
+ * @n eOpDone or eOpFailed. There is no self check readback.
+ * @param levels  The sensitivity levels of channel 1~4.
+ * @return start state:
+ * @n      true:  The operation is started.
+ * @n      false: Another operation is running.
+ */
+  bool startSetSensitivityLevels(const uint8_t levels[4]);
+  using DFRobot_Nilometer::getSensitivity;
+/**
+ * @brief Get sensitivity level of a channel of sensor.
+ * @param channel  1~4
+ * @return sensitivity level:
+ * @n     channel 1:   the level which is reported by the last selfCheck.
+ * @n     channel 2~4: the level which is acked by the last setSensitivityLevel or setSensitivityLevels.
+ * @n     0xFF:        unknown or error channel.
+ */
+  uint8_t getSensitivity(uint8_t channel);
+/**
+ * @brief Clear the result of auto-tune, call it before the first tuneSensitivity.
+ */
+  void resetTune(sTuneRslt_t *rslt);
+/**
+ * @brief Auto-tune step: with the tank in a known state, binary search the 8 sensitivity levels of channel 1 for the
+ * @n boundary between water and no water. The detection is monotonic in the level, so at most 4 levels are probed.
+ * @n All levels share one power cycle of the sensor, every probe costs a sensitivity frame and one or two detection frames.
+ * @param water  The known state of the tank: false: empty(no water at the probe), true: full(water at the probe).
+ * @param rslt   The result, emptyMin or fullMax and the readings are updated.
+ * @return true: sweep completed, false: the sensor did not answer.
+ */
+  bool tuneSensitivity(bool water, sTuneRslt_t *rslt);
+/**
+ * @brief Auto-tune final step: after tuneSensitivity with the empty tank and with the full tank, choose the level with the
+ * @n best margin, the middle of [emptyMin, fullMax], and set it.
+ * @param rslt   The result, level is updated.
+ * @return The chosen level 0~7, TUNE_LEVEL_NONE: no level separates empty and full, or the setting failed.
+ */
+  uint8_t applyTune(sTuneRslt_t *rslt);
+/**
+ * @brief Start a duty-cycled sample without blocking, call step until it returns eOpDone or eOpFailed.
+ * @n The sensor is powered on through EN(after EN has been low for POWER_OFF_TIME), the sample ends at the first
+ * @n SCW8916B_SAMPLE_FRAMES valid detection frames and powers the sensor down again. The time to the first frame is
+ * @n measured and averaged, the sample waits twice that estimate plus SAMPLE_FRAME_MARGIN for the frames.
+ * @n Inside a configuration session the sensor is not power cycled and stays on.
+ * @return true: started, false: EN is not connected or another operation is running.
+ */
+  bool startSample();
+/**
+ * @brief Take one duty-cycled sample, the blocking version of startSample.
+ * @return true: lastChannels and lastState hold the fresh reading, false: no valid frame.
+ */
+  bool sample();
+/**
+ * @brief Get the statistics of the duty-cycled samples: the powered time per sample and the warm-up estimate.
+ * @n The energy of a sample is its powered time times the supply current of the sensor.
+ */
+  const sSampleStats_t *getSampleStats();
+/**
+ * @brief Clear the statistics of the duty-cycled samples, the warm-up estimate is kept.
+ */
+  void resetSampleStats();
+protected:
+/**
+ * @brief Set the sensitivity level of channel 1, keep the other channels, and read a fresh detection frame.
+ * @return water state mask of the fresh frame, ERR_CHANNELS_CODE: fail.
+ */
+  uint8_t probeLevel(uint8_t level);
 };
 #endif
@@ -0,0 +1,124 @@
+/*!
+ * @file DFRobot_SCW8916B_Filter.h
+ * @brief Debounce and hysteresis filter between the raw water states and the reported state, it removes the
+ * @n chatter near the threshold(sloshing water, foam). Each of the 4 channels is filtered independently:
+ * @n 1. the last WINDOW samples are kept in a shift register, with a running count of the wet samples;
+ * @n 2. a dry channel becomes wet when at least ON_COUNT samples of the window are wet,
+ * @n    a wet channel becomes dry when at least OFF_COUNT samples of the window are dry(asymmetric hysteresis,
+ * @n    ON_COUNT = OFF_COUNT = WINDOW / 2 + 1 is a plain majority of WINDOW). ON_COUNT + OFF_COUNT must exceed
+ * @n    WINDOW, otherwise one window could satisfy both thresholds and the filter would toggle on every sample;
+ * @n 3. a channel does not change again until it has kept its state for MIN_DWELL_MS.
+ * @n All parameters are compile-time constants, the filter is a few bytes of fixed-size state, no heap,
+ * @n and every sample costs the same constant time.
+ * @n Feed one sample per frame: in UART detected mode every time poll returns true, in level one-to-one
+ * @n detection mode at a fixed rate, for example:
+ * @n   DFRobot_SCW8916B_Filter<5, 4, 2, 500> filter;
+ * @n   if(liquid.poll() && filter.update(liquid.lastChannels(), millis())){ ...filter.channels()... }
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_FILTER_H
+#define __DFRobot_SCW8916B_FILTER_H
+
+#include "DFRobot_SCW8916B.h"
+
+/**
+ * @brief Debounce and hysteresis filter.
+ * @param WINDOW        Number of samples in the window, ranging 1~32.
+ * @param ON_COUNT      Wet samples in the window which are required to report water, ranging 1~WINDOW.
+ * @param OFF_COUNT     Dry samples in the window which are required to report no water, ranging 1~WINDOW,
+ * @n                   ON_COUNT + OFF_COUNT > WINDOW.
+ * @param MIN_DWELL_MS  Minimum time between two changes of a channel, unit: ms, 0: no limit.
+ */
+template<uint8_t WINDOW, uint8_t ON_COUNT = WINDOW / 2 + 1, uint8_t OFF_COUNT = WINDOW / 2 + 1, uint16_t MIN_DWELL_MS = 0>
+class DFRobot_SCW8916B_Filter{
+  static_assert((WINDOW >= 1) && (WINDOW <= 32), "WINDOW must be 1~32");
+  static_assert((ON_COUNT >= 1) && (ON_COUNT <= WINDOW), "ON_COUNT must be 1~WINDOW");
+  static_assert((OFF_COUNT >= 1) && (OFF_COUNT <= WINDOW), "OFF_COUNT must be 1~WINDOW");
+  static_assert(ON_COUNT + OFF_COUNT > WINDOW, "ON_COUNT + OFF_COUNT must be greater than WINDOW");
+public:
+  DFRobot_SCW8916B_Filter(){
+    reset();
+  }
+/**
+ * @brief Forget every sample, the next sample fills the whole window.
+ */
+  void reset(){
+    _valid = false;
+    _channels = 0;
+    for(uint8_t i = 0; i < 4; i++){
+        _hist[i] = 0;
+        _wet[i] = 0;
+        _since[i] = 0;
+    }
+  }
+/**
+ * @brief Feed one sample.
+ * @param channels  The raw water state mask, bit0~bit3: channel 1~4. ERR_CHANNELS_CODE is ignored.
+ * @param now       The time of the sample, unit: ms(millis()).
+ * @return true: the filtered state changed, false: the filtered state is unchanged.
+ */
+  bool update(uint8_t channels, uint32_t now){
+    uint8_t old = _channels;
+    if(channels == ERR_CHANNELS_CODE) return false;
+    if(!_valid){
+        _valid = true;
+        _channels = channels & 0x0F;
+        for(uint8_t i = 0; i < 4; i++){
+            uint8_t in = (channels >> i) & 0x01;
+            _hist[i] = in ? mask() : 0;
+            _wet[i] = in ? WINDOW : 0;
+            _since[i] = now;
+        }
+        return true;
+    }
+    for(uint8_t i = 0; i < 4; i++){
+        uint8_t in = (channels >> i) & 0x01;
+        uint8_t out = (_hist[i] >> (WINDOW - 1)) & 0x01;
+        _hist[i] = ((_hist[i] << 1) | in) & mask();
+        _wet[i] = _wet[i] + in - out;
+        if(MIN_DWELL_MS && (uint32_t)(now - _since[i]) < MIN_DWELL_MS) continue;
+        if((_channels >> i) & 0x01){
+            if((uint8_t)(WINDOW - _wet[i]) >= OFF_COUNT){
+                _channels &= ~(1 << i);
+                _since[i] = now;
+            }
+        }else if(_wet[i] >= ON_COUNT){
+            _channels |= 1 << i;
+            _since[i] = now;
+        }
+    }
+    return _channels != old;
+  }
+/**
+ * @brief Get the filtered water state mask.
+ * @return water state mask, bit0~bit3: channel 1~4, 0xFF(ERR_CHANNELS_CODE): no sample yet.
+ */
+  uint8_t channels(){
+    return _valid ? _channels : ERR_CHANNELS_CODE;
+  }
+/**
+ * @brief Get the filtered water state of channel 1.
+ * @return true: There is water, false: There is no water or no sample yet.
+ */
+  bool state(){
+    return _valid && (_channels & WATER_CHANNEL_1);
+  }
+
+private:
+  static constexpr uint32_t mask(){
+    return (WINDOW == 32) ? 0xFFFFFFFFUL : ((1UL << (WINDOW & 0x1F)) - 1);
+  }
+  uint32_t _hist[4];
+  uint32_t _since[4];
+  uint8_t _wet[4];
+  uint8_t _channels;
+  bool _valid;
+};
+
+#endif
@@ -0,0 +1,281 @@
+/*!
+ * @file DFRobot_SCW8916B_Fixed.h
+ * @brief Compile-time specialised driver of the Non-contact liquid level sensor for small MCUs.
+ * @n The stream type, the detection mode and the pins are template parameters:
+ * @n 1. byte I/O calls StreamT directly(qualified call), there is no virtual Stream dispatch in the read path;
+ * @n 2. the code of the other detection mode and the checks of the pins which are not connected(-1) compile away;
+ * @n 3. there is no event queue, a frame is decoded as soon as it is read, with the rules of DFRobot_SCW8916B_Parser.
+ * @n The command frames, the timings and the OUT pin sequences come from DFRobot_SCW8916B_Protocol and the command
+ * @n replies are matched by DFRobot_SCW8916B_Parser, the same code as DFRobot_Nilometer.
+ * @n StreamT must be the concrete class of the serial port, for example HardwareSerial or SoftwareSerial,
+ * @n use DFRobot_SCW8916B_NoStream if the TX pin of the sensor is not connected in level one-to-one detection mode.
+ * @n The blocking API is the same as DFRobot_SCW8916B_UART/DFRobot_SCW8916B_IO, the asynchronous operations,
+ * @n the sessions, the snapshot and the statistics are only in DFRobot_Nilometer.
+ * @n example:
+ * @n   DFRobot_SCW8916B_Fixed<HardwareSerial, DFRobot_Nilometer::eUARTDetecteMode, 2> liquid(&Serial1);
+ * @n   DFRobot_SCW8916B_Fixed<DFRobot_SCW8916B_NoStream, DFRobot_Nilometer::eLevelDetecteMode, -1, 3> level;
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_FIXED_H
+#define __DFRobot_SCW8916B_FIXED_H
+
+#include "DFRobot_SCW8916B.h"
+
+class DFRobot_SCW8916B_NoStream{
+public:
+  int available(){ return 0; }
+  int read(){ return -1; }
+  size_t write(const uint8_t *buffer, size_t size){ (void)buffer; (void)size; return 0; }
+};
+
+template<typename StreamT, DFRobot_Nilometer::eDetecteMode_t MODE, int EN = -1, int OUT = -1, int TEST = -1>
+class DFRobot_SCW8916B_Fixed{
+public:
+/**
+ * @brief DFRobot_SCW8916B_Fixed constructor.
+ * @param s  The serial port, required in UART detected mode and by selfCheck in level one-to-one detection mode.
+ */
+  DFRobot_SCW8916B_Fixed(StreamT *s = NULL)
+    :_s(s),_state(0),_stateValid(false),_newState(false)
+  {
+    _rslt.value = 0;
+    _rslt.pad = 0;
+  }
+
+/**
+ * @brief liquide level sensor initialization, the same as DFRobot_Nilometer::begin.
+ * @param budget  The startup time budget, unit: ms.
+ * @return 0: sucess, 0xAA(ERR_CALIBRATION_CODE): the sensor has never been calibrated, -1: fail
+ */
+  int begin(uint16_t budget = SCW8916B_DISCOVERY_BUDGET){
+    uint32_t start = millis();
+    if(MODE == DFRobot_Nilometer::eUARTDetecteMode){
+        if(_s == NULL) return -1;
+        while(1){
+            uint8_t type = pump();
+            if(type == DFRobot_SCW8916B_Parser::eEventDetect) return 0;
+            if(type == DFRobot_SCW8916B_Parser::eEventUncalibrated) return ERR_CALIBRATION_CODE;
+            if((uint32_t)(millis() - start) >= budget) return 0;
+            delay(1);
+        }
+    }else{
+        DFRobot_SCW8916B_Protocol::sToggleWatch_t watch;
+        if(OUT < 0) return -1;
+        pinMode(OUT, INPUT);
+        DFRobot_SCW8916B_Protocol::toggleStart(&watch, digitalRead(OUT), start);
+        while((uint32_t)(millis() - start) < budget){
+            if(DFRobot_SCW8916B_Protocol::toggleUpdate(&watch, digitalRead(OUT), millis())) return ERR_CALIBRATION_CODE;
+            delay(1);
+        }
+        return 0;
+    }
+  }
+
+/**
+ * @brief Non-blocking detection, the same as DFRobot_Nilometer::poll.
+ * @return true: A new water state arrived, false: No new water state.
+ */
+  bool poll(){
+    if(MODE == DFRobot_Nilometer::eUARTDetecteMode){
+        return pump() == DFRobot_SCW8916B_Parser::eEventDetect;
+    }else{
+        uint8_t val;
+        if(OUT < 0) return false;
+        val = digitalRead(OUT) ? 1 : 0;
+        if(_stateValid && val == _state) return false;
+        _state = val;
+        _stateValid = true;
+        _newState = true;
+        return true;
+    }
+  }
+  bool available(){ return _newState; }
+  bool lastState(){
+    _newState = false;
+    return (bool)(_state & WATER_CHANNEL_1);
+  }
+  uint8_t lastChannels(){
+    _newState = false;
+    return _stateValid ? _state : ERR_CHANNELS_CODE;
+  }
+
+/**
+ * @brief Detect the presence or absence of water on all channels, the same as DFRobot_Nilometer::detectWaterChannels.
+ * @return water state mask, 0xFF(ERR_CHANNELS_CODE): No valid frame was received.
+ */
+  uint8_t detectWaterChannels(){
+    uint8_t channels = ERR_CHANNELS_CODE;
+    if(poll() || (MODE == DFRobot_Nilometer::eLevelDetecteMode && _stateValid)){
+        channels = lastChannels();
+    }
+    delay(100);
+    return channels;
+  }
+  bool detectWater(){
+    uint8_t channels = detectWaterChannels();
+    if(channels == ERR_CHANNELS_CODE) return false;
+    return (bool)(channels & WATER_CHANNEL_1);
+  }
+
+/**
+ * @brief Self check, the same as DFRobot_Nilometer::selfCheck.
+ * @return true: update sucess, false: update fail.
+ */
+  bool selfCheck(){
+    if(EN < 0 || _s == NULL) return false;
+    if(MODE == DFRobot_Nilometer::eUARTDetecteMode){
+        uint8_t cmd = SELF_CHECK_CMD;
+        enableSensor();
+        _s->write(&cmd, 1);
+        return waitReply(0, SELF_CHECK_UART_TIMEOUT);
+    }else{
+        if(TEST < 0 || OUT < 0) return false;
+        pinMode(TEST, OUTPUT);
+        digitalWrite(TEST, HIGH);
+        enableSensor();
+        digitalWrite(TEST, LOW);
+        delay(SELF_CHECK_IO_TIME);
+        digitalWrite(TEST, HIGH);
+        return waitReply(0, SELF_CHECK_IO_TIMEOUT);
+    }
+  }
+
+/**
+ * @brief Lower water level calibration, the same as DFRobot_Nilometer::calibration.
+ * @return true: Calibration sucess, false: Calibration fail.
+ */
+  bool calibration(){
+    if(EN < 0) return false;
+    if(MODE == DFRobot_Nilometer::eUARTDetecteMode){
+        uint8_t cmd = CALIB_UART_CMD_LWL;
+        if(_s == NULL) return false;
+        enableSensor();
+        _s->write(&cmd, 1);
+        return waitReply(DFRobot_SCW8916B_Protocol::calibrationAck(cmd), CALIB_TIMEOUT);
+    }else{
+        DFRobot_SCW8916B_Protocol::sCalibWatch_t watch;
+        uint32_t start;
+        if(TEST < 0 || OUT < 0) return false;
+        pinMode(TEST, OUTPUT);
+        digitalWrite(TEST, HIGH);
+        enableSensor();
+        digitalWrite(TEST, LOW);
+        delay(CALIB_IO_TIME_LWL);
+        digitalWrite(TEST, HIGH);
+        start = millis();
+        DFRobot_SCW8916B_Protocol::calibStart(&watch, digitalRead(OUT), start);
+        while((uint32_t)(millis() - start) <= CALIB_TIMEOUT){
+            if(DFRobot_SCW8916B_Protocol::calibUpdate(&watch, digitalRead(OUT), millis(), CALIB_IO_TIME_LWL)) return true;
+            delay(1);
+        }
+        return false;
+    }
+  }
+
+/**
+ * @brief Set sensitivity level of the channel 1 of sensor, only in UART detected mode(checked at compile time).
+ * @param level  0~7
+ * @return true: Set sensitivity sucess, false: Set sensitivity fail.
+ */
+  bool setSensitivityLevel(uint8_t level){
+    static_assert(MODE == DFRobot_Nilometer::eUARTDetecteMode, "setSensitivityLevel needs eUARTDetecteMode");
+    const uint8_t levels[4] = {level, 7, 7, 7};
+    uint8_t buf[SENSITIVITY_FRAME_LEN];
+    if(EN < 0 || _s == NULL) return false;
+    DFRobot_SCW8916B_Protocol::sensitivityFrame(levels, buf);
+    enableSensor();
+    _s->write(buf, sizeof(buf));
+    return waitReply(SENSITIVITY_ACK, SENSITIVITY_TIMEOUT);
+  }
+
+  uint8_t getSensitivity(){
+    return DFRobot_SCW8916B_Parser::isSelfCheckPair(_rslt.value, _rslt.pad) ? _rslt.sen : 0xFF;
+  }
+  uint8_t getCalibrationMode(){
+    return DFRobot_SCW8916B_Parser::isSelfCheckPair(_rslt.value, _rslt.pad) ? _rslt.topt : 0xFF;
+  }
+
+private:
+  inline void decode(uint8_t val, uint8_t *type){
+    if(DFRobot_SCW8916B_Parser::isDetectFrame(val)){
+        _state = val & 0x0F;
+        _stateValid = true;
+        _newState = true;
+        *type = DFRobot_SCW8916B_Parser::eEventDetect;
+    }else if(val == ERR_CALIBRATION_CODE && *type == DFRobot_SCW8916B_Parser::eEventNone){
+        *type = DFRobot_SCW8916B_Parser::eEventUncalibrated;
+    }
+  }
+
+  uint8_t pump(){
+    uint8_t type = DFRobot_SCW8916B_Parser::eEventNone;
+    if(_s == NULL) return type;
+    while(_s->StreamT::available() > 0){
+        decode((uint8_t)_s->StreamT::read(), &type);
+    }
+    return type;
+  }
+
+  /* The reply is matched by the parser of DFRobot_Nilometer, the frames which arrive meanwhile update the state. */
+  bool waitReply(uint8_t ack, uint16_t timeout){
+    uint32_t start = millis();
+    DFRobot_SCW8916B_Parser parser;
+    DFRobot_SCW8916B_Parser::sEvent_t ev;
+    bool ret = false;
+    if(ack){
+        parser.expectAck(ack);
+    }else{
+        parser.expectSelfCheck(true);
+    }
+    while(!ret && (uint32_t)(millis() - start) < timeout){
+        while(!ret && _s->StreamT::available() > 0){
+            parser.push((uint8_t)_s->StreamT::read());
+            if(parser.reply(&ev)){
+                if(ev.type == DFRobot_SCW8916B_Parser::eEventSelfCheck){
+                    _rslt.value = ev.data[0];
+                    _rslt.pad = ev.data[1];
+                }
+                ret = true;
+            }
+        }
+        if(!ret) delay(1);
+    }
+    parser.expectSelfCheck(false);
+    while(parser.pop(&ev)){
+        if(ev.type == DFRobot_SCW8916B_Parser::eEventDetect){
+            _state = ev.data[0];
+            _stateValid = true;
+            _newState = true;
+        }
+    }
+    return ret;
+  }
+
+  void enableSensor(){
+    if(EN < 0) return;
+    pinMode(EN, OUTPUT);
+    digitalWrite(EN, LOW);
+    delay(POWER_OFF_TIME);
+    if(_s != NULL){
+        while(_s->StreamT::available() > 0){
+            _s->StreamT::read();
+        }
+    }
+    digitalWrite(EN, HIGH);
+    delay(POWER_SETTLE_TIME);
+  }
+
+  StreamT *_s;
+  DFRobot_Nilometer::sSelfCheckRslt_t _rslt;
+  uint8_t _state;
+  bool _stateValid;
+  bool _newState;
+};
+
+#endif
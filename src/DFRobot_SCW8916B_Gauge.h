@@ -0,0 +1,272 @@
+/*!
+ * @file DFRobot_SCW8916B_Gauge.h
+ * @brief Level gauge of one tank from N probes at known heights: stacked sensors, the 4 channels of one sensor
+ * @n (uCheckRslt_t) or a bank of sensors in level one-to-one detection mode(DFRobot_SCW8916B_IOBank::getLevels).
+ * @n Probe 0 is the lowest one. Water wets the probes from the bottom up, so a valid wet mask is a run of ones
+ * @n from bit 0(mask & (mask + 1) == 0); any other mask, such as an upper probe wet above a dry one, is rejected
+ * @n and the last level is kept.
+ * @n Every change of the wet probes is a crossing: the water is at the height of the probe which changed at that
+ * @n time. The fill rate is a moving average(EWMA, weight 1 / 2^RATE_SHIFT) of the rates between two crossings,
+ * @n between crossings the level is extrapolated with the rate and kept between the neighbour probes.
+ * @n Every update and every query costs constant time, no heap, no floating point and only 32-bit arithmetic(no
+ * @n 64-bit library routines on AVR), for example:
+ * @n   DFRobot_SCW8916B_Gauge<6> gauge;
+ * @n   gauge.begin(heights);
+ * @n   if(bank.service()) gauge.update(bank.getLevels(), millis());
+ * @n   ...gauge.estimate(millis()), gauge.timeToFull(millis())...
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_GAUGE_H
+#define __DFRobot_SCW8916B_GAUGE_H
+
+#include "DFRobot_SCW8916B.h"
+
+#define GAUGE_NO_ESTIMATE   0xFFFFFFFFUL   /**<timeToFull/timeToEmpty: the level does not move in that direction*/
+
+/**
+ * @brief Level gauge of one tank.
+ * @param N           Number of probes, ranging 1~32.
+ * @param RATE_SHIFT  Weight of a new rate sample in the moving average is 1 / 2^RATE_SHIFT, ranging 0~7.
+ */
+template<uint8_t N, uint8_t RATE_SHIFT = 2>
+class DFRobot_SCW8916B_Gauge{
+  static_assert((N >= 1) && (N <= 32), "N must be 1~32");
+  static_assert(RATE_SHIFT <= 7, "RATE_SHIFT must be 0~7");
+public:
+  DFRobot_SCW8916B_Gauge(){
+    for(uint8_t i = 0; i < N; i++){
+        _height[i] = 0;
+    }
+    reset();
+  }
+/**
+ * @brief Set the heights of the probes and forget the level.
+ * @param heights  The height of probe 0~N-1 above the bottom of the tank, unit: mm, strictly increasing.
+ * @return true: sucess, false: the heights are not increasing.
+ */
+  bool begin(const uint16_t *heights){
+    for(uint8_t i = 1; i < N; i++){
+        if(heights[i] <= heights[i - 1]) return false;
+    }
+    for(uint8_t i = 0; i < N; i++){
+        _height[i] = heights[i];
+    }
+    reset();
+    return true;
+  }
+/**
+ * @brief Forget the level and the rate, the heights are kept.
+ */
+  void reset(){
+    _valid = false;
+    _rateValid = false;
+    _crossed = false;
+    _consistent = true;
+    _raw = 0;
+    _wet = 0;
+    _anchor = 0;
+    _rate = 0;
+    _since = 0;
+    _rejected = 0;
+  }
+/**
+ * @brief Feed the wet probes.
+ * @param mask  bit0~bit(N-1): probe 0~N-1, 1: wet, 0: dry.
+ * @param now   The time of the sample, unit: ms(millis()).
+ * @return true: the level changed, false: no change or the mask is rejected.
+ */
+  bool update(uint32_t mask, uint32_t now){
+    uint8_t wet = 0, old = _wet;
+    uint16_t anchor;
+    mask &= probeMask();
+    _raw = mask;
+    if(mask & (mask + 1)){
+        _consistent = false;
+        _rejected++;
+        return false;
+    }
+    _consistent = true;
+    while(mask){
+        wet++;
+        mask >>= 1;
+    }
+    if(!_valid){
+        _valid = true;
+        _wet = wet;
+        _anchor = low();
+        _since = now;
+        return true;
+    }
+    if(wet == old) return false;
+    /* Rising: the water reached the highest new wet probe, falling: it left the lowest new dry probe. */
+    anchor = (wet > old) ? _height[wet - 1] : _height[wet];
+    /* The first valid mask is no crossing, the water can be anywhere between the probes. */
+    if(_crossed && (uint32_t)(now - _since) > 0){
+        int32_t sample = perSecond((int32_t)anchor - _anchor, now - _since);
+        if(_rateValid){
+            _rate += (sample - _rate) / (1 << RATE_SHIFT);
+        }else{
+            _rate = sample;
+            _rateValid = true;
+        }
+    }
+    _crossed = true;
+    _wet = wet;
+    _anchor = anchor;
+    _since = now;
+    return true;
+  }
+/**
+ * @brief Feed the state of one probe, the other probes keep their last state.
+ * @param index  The probe, 0~N-1.
+ * @param wet    true: the probe is wet.
+ * @param now    The time of the sample, unit: ms(millis()).
+ * @return The same as update.
+ */
+  bool updateProbe(uint8_t index, bool wet, uint32_t now){
+    uint32_t mask = _raw;
+    if(index >= N) return false;
+    if(wet) mask |= (uint32_t)1 << index;
+    else mask &= ~((uint32_t)1 << index);
+    return update(mask, now);
+  }
+/**
+ * @brief Feed the channels of one sensor which are the probes 0~3(channel 1 is the lowest).
+ * @param channels  The water state mask, bit0~bit3: channel 1~4. ERR_CHANNELS_CODE is ignored.
+ * @return The same as update.
+ */
+  bool updateChannels(uint8_t channels, uint32_t now){
+    if(channels == ERR_CHANNELS_CODE) return false;
+    return update(channels & 0x0F, now);
+  }
+/**
+ * @brief The number of wet probes, 0~N, the water is between the height of probe wetProbes()-1 and wetProbes().
+ */
+  uint8_t wetProbes(){ return _wet; }
+/**
+ * @brief The level at the last crossing, unit: mm. Before the first crossing, the height of the highest wet probe
+ * @n (0 if none). The rate needs two crossings.
+ */
+  uint16_t level(){ return _anchor; }
+/**
+ * @brief The level extrapolated with the fill rate, kept between the highest wet and the lowest dry probe.
+ * @param now  unit: ms(millis()).
+ * @return The level, unit: mm.
+ */
+  uint16_t estimate(uint32_t now){
+    int32_t level = _anchor;
+    if(_rateValid){
+        level += travel(rate(now), now - _since);
+    }
+    if(level < (int32_t)low()) level = low();
+    if(level > (int32_t)high()) level = high();
+    return (uint16_t)level;
+  }
+/**
+ * @brief The fill rate, positive: filling, negative: draining. It is limited by the time since the last crossing,
+ * @n so a tank which stops moving between two probes tends to 0.
+ * @param now  unit: ms(millis()).
+ * @return unit: um/s, 0 if there is no rate yet.
+ */
+  int32_t rate(uint32_t now){
+    uint32_t elapsed = now - _since;
+    int32_t bound;
+    if(!_rateValid) return 0;
+    if(elapsed == 0) return _rate;
+    if(_rate > 0){
+        if(_wet >= N) return _rate;
+        bound = perSecond(high() - _anchor, elapsed);
+        return (_rate > bound) ? bound : _rate;
+    }
+    bound = perSecond(_anchor - low(), elapsed);
+    return (-_rate > bound) ? -bound : _rate;
+  }
+/**
+ * @brief The time until the water reaches the highest probe.
+ * @param now  unit: ms(millis()).
+ * @return unit: s, 0: the highest probe is wet, GAUGE_NO_ESTIMATE: the tank is not filling.
+ */
+  uint32_t timeToFull(uint32_t now){
+    int32_t r = rate(now);
+    if(_valid && _wet >= N) return 0;
+    if(!_valid || r <= 0) return GAUGE_NO_ESTIMATE;
+    return (uint32_t)((int32_t)(_height[N - 1] - estimate(now)) * 1000L / r);
+  }
+/**
+ * @brief The time until the lowest probe becomes dry.
+ * @param now  unit: ms(millis()).
+ * @return unit: s, 0: every probe is dry, GAUGE_NO_ESTIMATE: the tank is not draining.
+ */
+  uint32_t timeToEmpty(uint32_t now){
+    int32_t r = rate(now);
+    if(_valid && _wet == 0) return 0;
+    if(!_valid || r >= 0) return GAUGE_NO_ESTIMATE;
+    return (uint32_t)((int32_t)(estimate(now) - _height[0]) * 1000L / -r);
+  }
+/**
+ * @brief false: the last mask was rejected(an upper probe is wet above a dry one), the level is the last valid one.
+ */
+  bool consistent(){ return _consistent; }
+/**
+ * @brief The number of rejected masks since reset.
+ */
+  uint32_t rejected(){ return _rejected; }
+/**
+ * @brief true: at least one valid mask has been fed.
+ */
+  bool valid(){ return _valid; }
+
+private:
+  /* mm per ms as um/s: one division up to 4294mm, above it in two steps of 1000, saturated at INT32_MAX. */
+  static int32_t perSecond(int32_t mm, uint32_t ms){
+    uint32_t m = (mm < 0) ? (uint32_t)-mm : (uint32_t)mm, v;
+    if(m <= 4294){
+        v = m * 1000000UL / ms;
+    }else{
+        uint32_t um = m * 1000, rem = um % ms;
+        if(um / ms > 0x7FFFFFFFUL / 1000){
+            v = 0x7FFFFFFFUL;
+        }else{
+            v = um / ms * 1000 + ((ms <= 4294967UL) ? rem * 1000 / ms : rem / (ms / 1000));
+        }
+    }
+    if(v > 0x7FFFFFFFUL) v = 0x7FFFFFFFUL;
+    return (mm < 0) ? -(int32_t)v : (int32_t)v;
+  }
+  /* um/s times ms as mm, saturated at 65535mm which is above every probe. */
+  static int32_t travel(int32_t umPerS, uint32_t ms){
+    uint32_t r = (umPerS < 0) ? (uint32_t)-umPerS : (uint32_t)umPerS, s = ms / 1000, v;
+    if(s && r / 1000 > 0xFFFFUL / s){
+        v = 0xFFFF;
+    }else{
+        v = r / 1000 * s + (r % 1000) * s / 1000 + r / 1000 * (ms % 1000) / 1000;
+        if(v > 0xFFFF) v = 0xFFFF;
+    }
+    return (umPerS < 0) ? -(int32_t)v : (int32_t)v;
+  }
+  static constexpr uint32_t probeMask(){
+    return (N == 32) ? 0xFFFFFFFFUL : ((1UL << (N & 0x1F)) - 1);
+  }
+  uint16_t low(){ return (_wet > 0) ? _height[_wet - 1] : 0; }
+  uint16_t high(){ return (_wet < N) ? _height[_wet] : _height[N - 1]; }
+
+  uint16_t _height[N];
+  uint16_t _anchor;    /**<The level at the last crossing, unit: mm*/
+  int32_t _rate;       /**<Moving average of the fill rate, unit: um/s*/
+  uint32_t _since;     /**<millis() of the last crossing*/
+  uint32_t _raw;       /**<The last mask, valid or not*/
+  uint32_t _rejected;
+  uint8_t _wet;
+  bool _valid;
+  bool _rateValid;
+  bool _crossed;
+  bool _consistent;
+};
+
+#endif
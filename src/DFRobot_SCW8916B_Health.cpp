@@ -0,0 +1,146 @@
+/*!
+ * @file DFRobot_SCW8916B_Health.cpp
+ * @brief Optional online health monitor of one sensor.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <Arduino.h>
+#include "DFRobot_SCW8916B_Health.h"
+
+#define HEALTH_VALIDITY_SHIFT   2    /**<Weight of a new window in the validity average is 1/4*/
+#define HEALTH_FLAP_ONE         16   /**<One state change in the decayed count*/
+#define HEALTH_FLAP_STEP_MS     (HEALTH_FLAP_HALF_LIFE_MS / 8)
+
+DFRobot_SCW8916B_Health::DFRobot_SCW8916B_Health()
+  :_silentMs(HEALTH_SILENT_MS),_stuckMs(HEALTH_STUCK_MS)
+{
+  reset();
+}
+
+void DFRobot_SCW8916B_Health::reset(){
+  memset(&_data, 0, sizeof(_data));
+  _lastValid = 0;
+  _lastChange = 0;
+  _flapTime = 0;
+  _validity = 0xFFFF;
+  _flap = 0;
+  _winValid = 0;
+  _winTotal = 0;
+  _state = 0;
+  _failRun = 0;
+  _seen = false;
+  _validitySeen = false;
+  _uncalibrated = false;
+}
+
+void DFRobot_SCW8916B_Health::setLimits(uint32_t silentMs, uint32_t stuckMs){
+  _silentMs = silentMs;
+  _stuckMs = stuckMs;
+}
+
+void DFRobot_SCW8916B_Health::onBytes(uint16_t valid, uint16_t invalid){
+  uint32_t total = (uint32_t)_winTotal + valid + invalid;
+  uint32_t sample;
+  if(total < HEALTH_WINDOW_BYTES){
+      _winValid += valid;
+      _winTotal = (uint16_t)total;
+      return;
+  }
+  sample = ((uint32_t)_winValid + valid) * 0xFFFF / total;
+  if(_validitySeen){
+      _validity = (uint16_t)((int32_t)_validity + ((int32_t)sample - (int32_t)_validity) / (1 << HEALTH_VALIDITY_SHIFT));
+  }else{
+      _validity = (uint16_t)sample;
+      _validitySeen = true;
+  }
+  _winValid = 0;
+  _winTotal = 0;
+}
+
+/* The count decays in steps of 1/8 half-life by 2^(-1/8)(235/256), after 16 half-lives it is 0. */
+void DFRobot_SCW8916B_Health::decay(uint32_t now){
+  uint32_t n = (now - _flapTime) / HEALTH_FLAP_STEP_MS;
+  if(n == 0) return;
+  _flapTime += n * HEALTH_FLAP_STEP_MS;
+  if(n >= 16 * 8){
+      _flap = 0;
+      return;
+  }
+  _flap >>= n / 8;
+  for(n = n % 8; n > 0; n--){
+      _flap = (uint16_t)(((uint32_t)_flap * 235) >> 8);
+  }
+}
+
+void DFRobot_SCW8916B_Health::onState(uint8_t state, uint32_t now){
+  _lastValid = now;
+  _uncalibrated = false;
+  if(!_seen){
+      _seen = true;
+      _state = state;
+      _lastChange = now;
+      _flapTime = now;
+      return;
+  }
+  if(state == _state) return;
+  _state = state;
+  _lastChange = now;
+  _data.changes++;
+  decay(now);
+  if(_flap <= 0xFFFF - HEALTH_FLAP_ONE) _flap += HEALTH_FLAP_ONE;
+}
+
+void DFRobot_SCW8916B_Health::onUncalibrated(){
+  _uncalibrated = true;
+}
+
+void DFRobot_SCW8916B_Health::onCommand(bool ok){
+  if(ok){
+      _failRun = 0;
+      return;
+  }
+  _data.commandFailures++;
+  if(_failRun < 0xFF) _failRun++;
+}
+
+const sSCW8916BHealth_t *DFRobot_SCW8916B_Health::get(uint32_t now){
+  uint16_t validity = _validity;
+  uint8_t reasons = 0;
+  bool failed = false;
+  if(!_validitySeen && _winTotal){
+      validity = (uint16_t)((uint32_t)_winValid * 0xFFFF / _winTotal);
+  }
+  decay(now);
+  _data.validity = (uint8_t)(((uint32_t)validity * 100 + 0x7FFF) / 0xFFFF);
+  _data.flaps = (uint8_t)((_flap / HEALTH_FLAP_ONE > 0xFF) ? 0xFF : _flap / HEALTH_FLAP_ONE);
+  _data.sinceValid = _seen ? now - _lastValid : 0xFFFFFFFFUL;
+  _data.stuck = _seen ? now - _lastChange : 0;
+  if(_seen && _silentMs && _data.sinceValid >= _silentMs){
+      reasons |= eHealthSilent;
+      failed = true;
+  }
+  if(_data.validity < HEALTH_MIN_VALIDITY){
+      reasons |= eHealthCorrupt;
+      if(_data.validity < HEALTH_FAIL_VALIDITY) failed = true;
+  }
+  if(_data.flaps >= HEALTH_FLAP_COUNT) reasons |= eHealthFlapping;
+  if(_seen && _stuckMs && _data.stuck >= _stuckMs) reasons |= eHealthStuck;
+  if(_uncalibrated) reasons |= eHealthUncalibrated;
+  if(_failRun >= HEALTH_COMMAND_FAILURES) reasons |= eHealthCommandFail;
+  _data.reasons = reasons;
+  if(!_seen && !_uncalibrated && !_winTotal && !_validitySeen && !_failRun){
+      _data.state = eHealthUnknown;
+  }else if(failed){
+      _data.state = eHealthFailed;
+  }else if(reasons){
+      _data.state = eHealthDegraded;
+  }else{
+      _data.state = eHealthOk;
+  }
+  return &_data;
+}
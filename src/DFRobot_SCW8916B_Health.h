@@ -0,0 +1,131 @@
+/*!
+ * @file DFRobot_SCW8916B_Health.h
+ * @brief Optional online health monitor of one sensor, it is fed by the traffic which the library already reads,
+ * @n so it costs no extra polling and no selfCheck power cycle. A few rolling values in constant memory:
+ * @n 1. validity: moving average of the share of received bytes which are valid frames(the rest fail the nibble
+ * @n    complement check and were discarded silently before);
+ * @n 2. the time since the last valid frame(UART) or OUT sample(level one-to-one detection mode);
+ * @n 3. flapping: the number of state changes with an exponential decay(half-life HEALTH_FLAP_HALF_LIFE_MS);
+ * @n 4. stuck-at: the time since the last state change;
+ * @n 5. uncalibrated markers and consecutive failed commands(including the timeouts of checkCalibrationState).
+ * @n They give a health state and a mask of reasons. The monitor is compiled out unless SCW8916B_ENABLE_HEALTH is 1.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_HEALTH_H
+#define __DFRobot_SCW8916B_HEALTH_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+//Define SCW8916B_ENABLE_HEALTH, change 0 to 1 to compile the health monitor in.
+#ifndef SCW8916B_ENABLE_HEALTH
+#define SCW8916B_ENABLE_HEALTH   0
+#endif
+
+#define HEALTH_WINDOW_BYTES       16      /**<Bytes per sample of the validity average*/
+#define HEALTH_MIN_VALIDITY       90      /**<Degraded below this validity, unit: %*/
+#define HEALTH_FAIL_VALIDITY      50      /**<Failed below this validity, unit: %*/
+#define HEALTH_FLAP_HALF_LIFE_MS  10000   /**<Half-life of the decayed number of state changes, unit: ms*/
+#define HEALTH_FLAP_COUNT         6       /**<Flapping from this decayed number of state changes*/
+#define HEALTH_COMMAND_FAILURES   3       /**<Degraded from this number of failed commands in a row*/
+#define HEALTH_SILENT_MS          3000    /**<Default: failed when no valid frame for this time, unit: ms*/
+#define HEALTH_STUCK_MS           0       /**<Default: degraded when the state does not change for this time, 0: off*/
+
+typedef enum{
+  eHealthUnknown = 0,   /**<Nothing has been received yet*/
+  eHealthOk,
+  eHealthDegraded,      /**<The readings are still coming but should not be trusted blindly*/
+  eHealthFailed         /**<No valid reading(silent link or mostly corrupt bytes)*/
+}eHealthState_t;
+
+typedef enum{
+  eHealthSilent        = 0x01,   /**<No valid frame or sample for the silent time*/
+  eHealthCorrupt       = 0x02,   /**<The validity is below HEALTH_MIN_VALIDITY*/
+  eHealthFlapping      = 0x04,   /**<The state changes too often*/
+  eHealthStuck         = 0x08,   /**<The state has not changed for the stuck time*/
+  eHealthUncalibrated  = 0x10,   /**<The sensor sends the uncalibrated marker*/
+  eHealthCommandFail   = 0x20    /**<HEALTH_COMMAND_FAILURES or more commands in a row failed*/
+}eHealthReason_t;
+
+typedef struct{
+  uint8_t state;               /**<eHealthState_t*/
+  uint8_t reasons;             /**<eHealthReason_t mask*/
+  uint8_t validity;            /**<Moving average of the valid bytes, unit: %*/
+  uint8_t flaps;               /**<Decayed number of state changes*/
+  uint32_t sinceValid;         /**<Time since the last valid frame or sample, unit: ms, 0xFFFFFFFF: never*/
+  uint32_t stuck;              /**<Time since the last state change, unit: ms*/
+  uint32_t changes;            /**<State changes since reset*/
+  uint32_t commandFailures;    /**<Failed commands since reset*/
+}sSCW8916BHealth_t;
+
+class DFRobot_SCW8916B_Health{
+public:
+  DFRobot_SCW8916B_Health();
+/**
+ * @brief Forget everything, the limits are kept.
+ */
+  void reset();
+/**
+ * @brief Set the limits of the silent link and the stuck state.
+ * @param silentMs  Failed when no valid frame or sample arrives for this time, unit: ms, 0: off.
+ * @param stuckMs   Degraded when the state does not change for this time, unit: ms, 0: off.
+ */
+  void setLimits(uint32_t silentMs, uint32_t stuckMs);
+/**
+ * @brief Count received bytes.
+ * @param valid    Valid detection frames.
+ * @param invalid  Discarded bytes.
+ */
+  void onBytes(uint16_t valid, uint16_t invalid);
+/**
+ * @brief A valid detection frame or OUT sample.
+ * @param state  The water state mask.
+ * @param now    millis().
+ */
+  void onState(uint8_t state, uint32_t now);
+/**
+ * @brief An uncalibrated marker, it is reported until the next valid frame.
+ */
+  void onUncalibrated();
+/**
+ * @brief A command finished.
+ * @param ok  false: it failed or timed out.
+ */
+  void onCommand(bool ok);
+/**
+ * @brief Evaluate the health.
+ * @param now  millis().
+ * @return The health, valid until the next call.
+ */
+  const sSCW8916BHealth_t *get(uint32_t now);
+
+private:
+  void decay(uint32_t now);
+
+  sSCW8916BHealth_t _data;
+  uint32_t _silentMs;
+  uint32_t _stuckMs;
+  uint32_t _lastValid;
+  uint32_t _lastChange;
+  uint32_t _flapTime;     /**<millis() up to which _flap is decayed*/
+  uint16_t _validity;     /**<Moving average of the valid bytes, 65535: 100%*/
+  uint16_t _flap;         /**<Decayed number of state changes, unit: 1/16*/
+  uint16_t _winValid;
+  uint16_t _winTotal;
+  uint8_t _state;
+  uint8_t _failRun;       /**<Failed commands in a row*/
+  bool _seen;             /**<A valid frame or sample has arrived*/
+  bool _validitySeen;     /**<The first validity window is complete*/
+  bool _uncalibrated;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/*!
+ * @file DFRobot_SCW8916B_IOBank.h
+ * @brief Sample the OUT pins of many sensors in level one-to-one detection mode at once.
+ * @n The sensors are grouped by GPIO port when they are added, service reads every port once and gives each
+ * @n sensor its bit of the port value(DFRobot_Nilometer::pollLevel), so a bank of sensors on one port costs
+ * @n one register read instead of one digitalRead per sensor. The port access is in DFRobot_SCW8916B_Port.h.
+ * @n Like DFRobot_SCW8916B_Manager, the bank keeps a state table and reports the changes by a bitmask and a callback.
+ * @n note: Do not enable the edge capture of the sensors in a bank, the bank samples the pins itself.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_IOBANK_H
+#define __DFRobot_SCW8916B_IOBANK_H
+
+#include "DFRobot_SCW8916B.h"
+#include "DFRobot_SCW8916B_Port.h"
+
+/**
+ * @brief Callback of a state change.
+ * @param index     The index of the sensor which is returned by addSensor.
+ * @param channels  The new water state, 0: no water, WATER_CHANNEL_1: have water.
+ */
+typedef void (*SCW8916BBankCallback_t)(uint8_t index, uint8_t channels);
+
+/**
+ * @brief Fixed-capacity bank of sensors in level one-to-one detection mode.
+ * @param N  The max number of sensors, ranging 1~32.
+ */
+template<uint8_t N>
+class DFRobot_SCW8916B_IOBank{
+  static_assert((N > 0) && (N <= 32), "N must be 1~32");
+public:
+  DFRobot_SCW8916B_IOBank()
+    :_count(0),_ports(0),_levels(0),_changed(0),_cb(NULL){}
+
+/**
+ * @brief Add a sensor, the OUT pin is resolved to its port here, not in service.
+ * @param sensor  The pointer of a DFRobot_SCW8916B_IO object whose OUT pin is connected.
+ * @return The index of the sensor, -1 if the sensor is NULL, has no OUT pin or port, or the bank is full.
+ */
+  int addSensor(DFRobot_SCW8916B_IO *sensor){
+    SCW8916BPortRef_t ref;
+    uint8_t port;
+    int out;
+    if(sensor == NULL || _count >= N) return -1;
+    out = sensor->getOutPin();
+    if(out < 0 || !DFRobot_SCW8916B_Port::resolve(out, &ref)) return -1;
+    pinMode(out, INPUT);
+    for(port = 0; port < _ports; port++){
+        if(_port[port] == ref) break;
+    }
+    if(port == _ports) _port[_ports++] = ref;
+    _sensor[_count] = sensor;
+    _portIndex[_count] = port;
+    _mask[_count] = DFRobot_SCW8916B_Port::mask(out);
+    _channels[_count] = ERR_CHANNELS_CODE;
+    return _count++;
+  }
+/**
+ * @brief The number of sensors which have been added.
+ */
+  uint8_t count(){ return _count; }
+/**
+ * @brief The number of different ports of the OUT pins, which is the number of port reads of each service.
+ */
+  uint8_t portCount(){ return _ports; }
+/**
+ * @brief Get a sensor by index.
+ * @return The pointer of the sensor, NULL if the index is out of range.
+ */
+  DFRobot_SCW8916B_IO *getSensor(uint8_t index){
+    return (index < _count) ? _sensor[index] : NULL;
+  }
+/**
+ * @brief Set the callback which is called on every state change, NULL to disable it.
+ */
+  void setCallback(SCW8916BBankCallback_t cb){ _cb = cb; }
+/**
+ * @brief Read the OUT pins of all sensors without updating the sensors, never blocks.
+ * @return Bitmask of sensor index, bit n: the OUT pin of sensor n is high(have water).
+ */
+  uint32_t sample(){
+    SCW8916BPortValue_t val[N];
+    uint32_t levels = 0;
+    for(uint8_t i = 0; i < _ports; i++){
+        val[i] = DFRobot_SCW8916B_Port::read(_port[i]);
+    }
+    for(uint8_t i = 0; i < _count; i++){
+        if(val[_portIndex[i]] & _mask[i]) levels |= (uint32_t)1 << i;
+    }
+    return levels;
+  }
+/**
+ * @brief Sample all sensors and update them, never blocks. available, lastState and lastChannels of every
+ * @n sensor work as after its own poll.
+ * @return The number of sensors whose state changed in this call.
+ */
+  uint8_t service(){
+    uint8_t changes = 0;
+    _levels = sample();
+    for(uint8_t i = 0; i < _count; i++){
+        uint8_t channels = (_levels >> i) & 0x01;
+        _sensor[i]->pollLevel(channels);
+        if(channels == _channels[i]) continue;
+        _channels[i] = channels;
+        _changed |= (uint32_t)1 << i;
+        changes++;
+        if(_cb != NULL) _cb(i, channels);
+    }
+    return changes;
+  }
+/**
+ * @brief The levels which are read by the last service.
+ * @return Bitmask of sensor index, bit n: sensor n has water.
+ */
+  uint32_t getLevels(){ return _levels; }
+/**
+ * @brief Get the water state of a sensor from the state table.
+ * @return 0: no water, WATER_CHANNEL_1: have water, 0xFF(ERR_CHANNELS_CODE): not sampled yet.
+ */
+  uint8_t getChannels(uint8_t index){
+    return (index < _count) ? _channels[index] : ERR_CHANNELS_CODE;
+  }
+/**
+ * @brief Get the water state of a sensor from the state table.
+ * @return true: There is water, false: There is no water or not sampled yet.
+ */
+  bool getState(uint8_t index){
+    uint8_t channels = getChannels(index);
+    return (channels != ERR_CHANNELS_CODE) && (channels & WATER_CHANNEL_1);
+  }
+/**
+ * @brief Take the sensors whose state changed since the last call.
+ * @return Bitmask of sensor index, bit n: sensor n changed.
+ */
+  uint32_t takeChanged(){
+    uint32_t changed = _changed;
+    _changed = 0;
+    return changed;
+  }
+
+private:
+  DFRobot_SCW8916B_IO *_sensor[N];
+  SCW8916BPortRef_t _port[N];        /**<The different ports of the OUT pins*/
+  SCW8916BPortValue_t _mask[N];      /**<The bit of the OUT pin of each sensor in its port*/
+  uint8_t _portIndex[N];             /**<The index in _port of each sensor*/
+  uint8_t _channels[N];
+  uint8_t _count;
+  uint8_t _ports;
+  uint32_t _levels;
+  uint32_t _changed;
+  SCW8916BBankCallback_t _cb;
+};
+
+#endif
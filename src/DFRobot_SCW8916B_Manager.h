@@ -0,0 +1,122 @@
+/*!
+ * @file DFRobot_SCW8916B_Manager.h
+ * @brief Service many SCW8916B sensors(UART or level one-to-one detection, any mix of streams and OUT pins) 
+ * @n from one loop without blocking. Every call of service polls the next sensors round-robin, each poll only
+ * @n costs the parsing of the bytes which have already arrived, so adding sensors does not add any delay.
+ * @n The manager keeps a state table of all sensors and reports the changes by a bitmask and a callback.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_MANAGER_H
+#define __DFRobot_SCW8916B_MANAGER_H
+
+#include "DFRobot_SCW8916B.h"
+
+/**
+ * @brief Callback of a state change.
+ * @param index     The index of the sensor which is returned by addSensor.
+ * @param channels  The new water state mask, bit0~bit3: channel 1~4.
+ */
+typedef void (*SCW8916BChangeCallback_t)(uint8_t index, uint8_t channels);
+
+/**
+ * @brief Fixed-capacity sensor manager.
+ * @param N  The max number of sensors, ranging 1~32.
+ */
+template<uint8_t N>
+class DFRobot_SCW8916B_Manager{
+  static_assert((N > 0) && (N <= 32), "N must be 1~32");
+public:
+  DFRobot_SCW8916B_Manager()
+    :_count(0),_next(0),_changed(0),_cb(NULL){}
+
+/**
+ * @brief Add a sensor, the sensor should have been initialized by begin.
+ * @param sensor  The pointer of a DFRobot_SCW8916B_UART or DFRobot_SCW8916B_IO object.
+ * @return The index of the sensor, -1 if the sensor is NULL or the manager is full.
+ */
+  int addSensor(DFRobot_Nilometer *sensor){
+    if(sensor == NULL || _count >= N) return -1;
+    _sensor[_count] = sensor;
+    _channels[_count] = ERR_CHANNELS_CODE;
+    return _count++;
+  }
+/**
+ * @brief The number of sensors which have been added.
+ */
+  uint8_t count(){ return _count; }
+/**
+ * @brief Get a sensor by index.
+ * @return The pointer of the sensor, NULL if the index is out of range.
+ */
+  DFRobot_Nilometer *getSensor(uint8_t index){
+    return (index < _count) ? _sensor[index] : NULL;
+  }
+/**
+ * @brief Set the callback which is called on every state change, NULL to disable it.
+ */
+  void setCallback(SCW8916BChangeCallback_t cb){ _cb = cb; }
+/**
+ * @brief Poll the next sensors round-robin, never blocks.
+ * @param budget  The max number of sensors to poll in this call, 0 means all sensors.
+ * @return The number of sensors whose state changed in this call.
+ */
+  uint8_t service(uint8_t budget = 0){
+    uint8_t changes = 0;
+    uint8_t channels;
+    if(_count == 0) return 0;
+    if(budget == 0 || budget > _count) budget = _count;
+    while(budget--){
+        uint8_t i = _next;
+        _next = (_next + 1 < _count) ? _next + 1 : 0;
+        _sensor[i]->poll();
+        if(!_sensor[i]->available()) continue;
+        channels = _sensor[i]->lastChannels();
+        if(channels == _channels[i]) continue;
+        _channels[i] = channels;
+        _changed |= (uint32_t)1 << i;
+        changes++;
+        if(_cb != NULL) _cb(i, channels);
+    }
+    return changes;
+  }
+/**
+ * @brief Get the water state mask of a sensor from the state table.
+ * @return water state mask, bit0~bit3: channel 1~4, 0xFF(ERR_CHANNELS_CODE): no valid state yet.
+ */
+  uint8_t getChannels(uint8_t index){
+    return (index < _count) ? _channels[index] : ERR_CHANNELS_CODE;
+  }
+/**
+ * @brief Get the water state of channel 1 of a sensor from the state table.
+ * @return true: There is water, false: There is no water or no valid state yet.
+ */
+  bool getState(uint8_t index){
+    uint8_t channels = getChannels(index);
+    return (channels != ERR_CHANNELS_CODE) && (channels & WATER_CHANNEL_1);
+  }
+/**
+ * @brief Take the sensors whose state changed since the last call.
+ * @return Bitmask of sensor index, bit n: sensor n changed.
+ */
+  uint32_t takeChanged(){
+    uint32_t changed = _changed;
+    _changed = 0;
+    return changed;
+  }
+
+private:
+  DFRobot_Nilometer *_sensor[N];
+  uint8_t _channels[N];
+  uint8_t _count;
+  uint8_t _next;
+  uint32_t _changed;
+  SCW8916BChangeCallback_t _cb;
+};
+
+#endif
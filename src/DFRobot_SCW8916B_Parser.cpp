@@ -0,0 +1,134 @@
+/*!
+ * @file DFRobot_SCW8916B_Parser.cpp
+ * @brief Incremental frame parser of the SCW8916B UART protocol.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <Arduino.h>
+#include "DFRobot_SCW8916B_Parser.h"
+
+#define PARSER_QUEUE_MASK       (SCW8916B_EVENT_QUEUE_SIZE - 1)
+#define PARSER_UNCALIBRATED     0xAA
+
+DFRobot_SCW8916B_Parser::DFRobot_SCW8916B_Parser()
+  :_hasHeld(false),_bytes(0),_frames(0),_checksumFailures(0),_discarded(0),_overflows(0)
+{
+  reset();
+}
+
+void DFRobot_SCW8916B_Parser::reset(){
+  if(_hasHeld) _discarded++;
+  _head = 0;
+  _tail = 0;
+  _reply.type = eEventNone;
+  _hasHeld = false;
+  _expectSelfCheck = false;
+  _expectAck = 0;
+}
+
+void DFRobot_SCW8916B_Parser::resetCounters(){
+  _bytes = 0;
+  _frames = 0;
+  _checksumFailures = 0;
+  _discarded = 0;
+  _overflows = 0;
+}
+
+void DFRobot_SCW8916B_Parser::expectSelfCheck(bool enable){
+  if(!enable && _hasHeld){
+      _hasHeld = false;
+      classify(_held);
+  }
+  _expectSelfCheck = enable;
+}
+
+void DFRobot_SCW8916B_Parser::expectAck(uint8_t ack){
+  _expectAck = ack;
+}
+
+uint8_t DFRobot_SCW8916B_Parser::push(uint8_t val){
+  uint8_t type = eEventNone;
+  _bytes++;
+  if(_expectAck && (val == _expectAck)){
+      _expectAck = 0;
+      _reply.type = eEventAck;
+      _reply.data[0] = val;
+      return eEventAck;
+  }
+  if(!_expectSelfCheck){
+      return classify(val);
+  }
+  if(_hasHeld){
+      if(isSelfCheckPair(_held, val)){
+          _hasHeld = false;
+          _expectSelfCheck = false;
+          _reply.type = eEventSelfCheck;
+          _reply.data[0] = _held;
+          _reply.data[1] = val;
+          return eEventSelfCheck;
+      }
+      type = classify(_held);
+  }
+  _held = val;
+  _hasHeld = true;
+  return type;
+}
+
+int DFRobot_SCW8916B_Parser::feed(Stream *s){
+  if(s == NULL) return 0;
+  int remain = s->available();
+  for(int i = 0; i < remain; i++){
+      push((uint8_t)s->read());
+  }
+  return remain;
+}
+
+bool DFRobot_SCW8916B_Parser::pop(sEvent_t *ev){
+  if(_head == _tail) return false;
+  *ev = _queue[_tail & PARSER_QUEUE_MASK];
+  _tail++;
+  return true;
+}
+
+bool DFRobot_SCW8916B_Parser::reply(sEvent_t *ev){
+  if(_reply.type == eEventNone) return false;
+  *ev = _reply;
+  _reply.type = eEventNone;
+  return true;
+}
+
+uint8_t DFRobot_SCW8916B_Parser::count(){
+  return (uint8_t)(_head - _tail);
+}
+
+uint8_t DFRobot_SCW8916B_Parser::classify(uint8_t val){
+  if(isDetectFrame(val)){
+      _frames++;
+      enqueue(eEventDetect, val & 0x0F);
+      return eEventDetect;
+  }
+  if(val == PARSER_UNCALIBRATED){
+      enqueue(eEventUncalibrated, val);
+      return eEventUncalibrated;
+  }
+  _checksumFailures++;
+  _discarded++;
+  return eEventNone;
+}
+
+void DFRobot_SCW8916B_Parser::enqueue(uint8_t type, uint8_t data){
+  if((uint8_t)(_head - _tail) >= SCW8916B_EVENT_QUEUE_SIZE){
+      _tail++;
+      _overflows++;
+  }
+  sEvent_t *ev = &_queue[_head & PARSER_QUEUE_MASK];
+  ev->type = type;
+  ev->data[0] = data;
+  ev->data[1] = 0;
+  _head++;
+}
@@ -0,0 +1,141 @@
+/*!
+ * @file DFRobot_SCW8916B_Parser.h
+ * @brief Incremental frame parser of the SCW8916B UART protocol.
+ * @n Every received byte is examined exactly once and classified as:
+ * @n 1. detection frame: low nibble is the channel mask, high nibble is its one's complement;
+ * @n 2. uncalibrated marker: ERR_CALIBRATION_CODE(0xAA);
+ * @n 3. self-check pair: two bytes whose sum is 0xFF, only when a self-check reply is expected;
+ * @n 4. ack byte: 0x53(sensitivity) or the nibble swapped calibration command, only when it is expected.
+ * @n Detection frames are kept in a fixed-size ring buffer until they are read, command replies are kept
+ * @n in a separate reply slot, so polling the detection state never steals the reply of a command.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_PARSER_H
+#define __DFRobot_SCW8916B_PARSER_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#include<Stream.h>
+
+#ifndef SCW8916B_EVENT_QUEUE_SIZE
+#define SCW8916B_EVENT_QUEUE_SIZE   8   /**<Capacity of the detection event ring buffer, must be a power of 2*/
+#endif
+
+class DFRobot_SCW8916B_Parser{
+public:
+typedef enum{
+  eEventNone = 0,     /**<No event*/
+  eEventDetect,       /**<Valid detection frame, data[0]: channel mask, bit0~bit3: channel 1~4*/
+  eEventUncalibrated, /**<The sensor has never been calibrated(0xAA)*/
+  eEventSelfCheck,    /**<Self-check pair, data[0]: value, data[1]: pad*/
+  eEventAck           /**<Expected ack byte, data[0]: ack byte*/
+}eEventType_t;
+
+typedef struct{
+  uint8_t type;    /**<eEventType_t*/
+  uint8_t data[2];
+}sEvent_t;
+
+  DFRobot_SCW8916B_Parser();
+/**
+ * @brief Drop every pending event, the reply slot and the expectations, the counters are kept.
+ */
+  void reset();
+/**
+ * @brief Expect a self-check pair. While it is expected, a byte is held back until the next one shows
+ * @n whether they form a self-check pair. The expectation ends when the pair arrives.
+ * @param enable  true: expect the pair, false: stop expecting it(the held byte is classified at once).
+ */
+  void expectSelfCheck(bool enable);
+/**
+ * @brief Expect an ack byte, the expectation ends when the ack arrives.
+ * @param ack  The expected ack byte, 0 means no ack is expected.
+ */
+  void expectAck(uint8_t ack);
+/**
+ * @brief Feed one received byte.
+ * @param val  The received byte.
+ * @return eEventType_t of the event which is emitted by the byte, eEventNone if there is none.
+ */
+  uint8_t push(uint8_t val);
+/**
+ * @brief Feed every byte which is available in the stream.
+ * @param s  The stream, NULL is ignored.
+ * @return The number of bytes consumed.
+ */
+  int feed(Stream *s);
+/**
+ * @brief Take the oldest detection event(eEventDetect or eEventUncalibrated).
+ * @param ev  The event.
+ * @return true: an event is taken, false: the queue is empty.
+ */
+  bool pop(sEvent_t *ev);
+/**
+ * @brief Take the command reply(eEventSelfCheck or eEventAck).
+ * @param ev  The reply.
+ * @return true: a reply is taken, false: there is no reply.
+ */
+  bool reply(sEvent_t *ev);
+/**
+ * @brief The number of detection events in the queue.
+ */
+  uint8_t count();
+/**
+ * @brief Counters since power on: bytes pushed, valid detection frames, checksum failures(pushed bytes which are
+ * @n neither frame, marker nor reply, they fail the nibble complement check), discarded bytes(the checksum failures
+ * @n plus the bytes which are thrown away unparsed, see discard) and detection events which are overwritten because
+ * @n the queue is full.
+ */
+  uint32_t bytesParsed(){ return _bytes; }
+  uint32_t framesDecoded(){ return _frames; }
+  uint32_t checksumFailures(){ return _checksumFailures; }
+  uint32_t bytesDiscarded(){ return _discarded; }
+  uint32_t eventsOverflowed(){ return _overflows; }
+/**
+ * @brief Count bytes which are thrown away without being parsed, for example the bytes which are drained from
+ * @n the serial port while the sensor is power cycled.
+ * @param n  The number of bytes.
+ */
+  void discard(uint32_t n){ _discarded += n; }
+/**
+ * @brief The frame rules, shared by every decoder of the library.
+ * @n isDetectFrame: the high nibble is the one's complement of the low nibble(the channel mask).
+ * @n isSelfCheckPair: the sum of the two bytes is 0xFF.
+ */
+  static inline bool isDetectFrame(uint8_t val){ return (uint8_t)((val >> 4) + (val & 0x0F)) == 0x0F; }
+  static inline bool isSelfCheckPair(uint8_t val, uint8_t pad){ return (uint8_t)(val + pad) == 0xFF; }
+/**
+ * @brief Clear the counters.
+ */
+  void resetCounters();
+
+protected:
+  uint8_t classify(uint8_t val);
+  void enqueue(uint8_t type, uint8_t data);
+
+  sEvent_t _queue[SCW8916B_EVENT_QUEUE_SIZE];
+  uint8_t _head;
+  uint8_t _tail;
+  sEvent_t _reply;
+  uint8_t _held;         /**<The byte which is held back while a self-check pair is expected*/
+  bool _hasHeld;
+  bool _expectSelfCheck;
+  uint8_t _expectAck;
+  uint32_t _bytes;
+  uint32_t _frames;
+  uint32_t _checksumFailures;
+  uint32_t _discarded;
+  uint32_t _overflows;
+};
+
+#endif
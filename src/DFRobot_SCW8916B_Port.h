@@ -0,0 +1,91 @@
+/*!
+ * @file DFRobot_SCW8916B_Port.h
+ * @brief GPIO port access for batched sampling of the OUT pins, used by DFRobot_SCW8916B_IOBank.
+ * @n A pin is resolved once to a port reference and a bit mask, after that a sample is one read of the port
+ * @n input register, without the pin-to-port lookups of digitalRead:
+ * @n 1. MCUs whose core provides portInputRegister(AVR, SAMD, ESP8266, ESP32): the input register is read directly;
+ * @n 2. the host build: the port is read through the pin backend of the shim(hostReadPort), so it can be mocked;
+ * @n 3. other MCUs: every pin is its own port and is read by digitalRead.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_PORT_H
+#define __DFRobot_SCW8916B_PORT_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#if defined(__HOST_ARDUINO_H)
+#define SCW8916B_PORT_IO
+typedef uint32_t SCW8916BPortValue_t;
+typedef uint8_t  SCW8916BPortRef_t;
+#elif defined(portInputRegister) && defined(digitalPinToPort) && defined(digitalPinToBitMask)
+#define SCW8916B_PORT_IO
+#if defined(ARDUINO_ARCH_AVR)
+typedef uint8_t  SCW8916BPortValue_t;
+#else
+typedef uint32_t SCW8916BPortValue_t;
+#endif
+typedef volatile SCW8916BPortValue_t *SCW8916BPortRef_t;
+#else
+typedef uint8_t  SCW8916BPortValue_t;
+typedef uint8_t  SCW8916BPortRef_t;
+#endif
+
+class DFRobot_SCW8916B_Port{
+public:
+/**
+ * @brief Resolve the port of a pin.
+ * @param pin  The pin, must not be negative.
+ * @param ref  The port reference.
+ * @return true: sucess, false: the pin has no port.
+ */
+  static inline bool resolve(int pin, SCW8916BPortRef_t *ref){
+#if defined(__HOST_ARDUINO_H)
+    if(pin >= HOST_MAX_PINS) return false;
+    *ref = digitalPinToPort(pin);
+#elif defined(SCW8916B_PORT_IO)
+#if defined(ARDUINO_ARCH_AVR)
+    if(digitalPinToPort(pin) == NOT_A_PIN) return false;
+#endif
+    *ref = (SCW8916BPortRef_t)portInputRegister(digitalPinToPort(pin));
+    if(*ref == NULL) return false;
+#else
+    *ref = (SCW8916BPortRef_t)pin;
+#endif
+    return true;
+  }
+/**
+ * @brief The bit of a pin in the value of its port.
+ */
+  static inline SCW8916BPortValue_t mask(int pin){
+#if defined(SCW8916B_PORT_IO)
+    return (SCW8916BPortValue_t)digitalPinToBitMask(pin);
+#else
+    (void)pin;
+    return 1;
+#endif
+  }
+/**
+ * @brief Read the input levels of a port.
+ */
+  static inline SCW8916BPortValue_t read(SCW8916BPortRef_t ref){
+#if defined(__HOST_ARDUINO_H)
+    return hostReadPort(ref);
+#elif defined(SCW8916B_PORT_IO)
+    return *ref;
+#else
+    return digitalRead(ref) ? 1 : 0;
+#endif
+  }
+};
+
+#endif
@@ -0,0 +1,129 @@
+/*!
+ * @file DFRobot_SCW8916B_Protocol.h
+ * @brief The command frames, timings and OUT pin sequences of the SCW8916B protocol, shared by DFRobot_Nilometer
+ * @n and DFRobot_SCW8916B_Fixed, so a protocol fix is made once. The byte rules(detection frame, self-check pair)
+ * @n are in DFRobot_SCW8916B_Parser. Every helper is static and inline, the watchers are a few bytes of state
+ * @n which the caller keeps and feeds with the level of the OUT pin.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_PROTOCOL_H
+#define __DFRobot_SCW8916B_PROTOCOL_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#define SELF_CHECK_CMD          0x34
+#define CALIB_UART_CMD_LWL      0x25
+#define CALIB_UART_CMD_UWL      0x8A
+#define CALIB_IO_TIME_LWL       100   /**<unit: ms*/
+#define CALIB_IO_TIME_UWL       200   /**<unit: ms*/
+#define SELF_CHECK_IO_TIME      500   /**<unit: ms*/
+#define UNCALIB_TOGGLE_TIME     100   /**<An uncalibrated sensor toggles OUT every 100ms, unit: ms*/
+#define UNCALIB_TOGGLES         3     /**<Number of toggles in a row which prove the sensor is uncalibrated*/
+
+#define SENSITIVITY_CMD         0x43  /**<First byte of the sensitivity frame*/
+#define SENSITIVITY_ACK         0x53  /**<Ack of the sensitivity frame*/
+#define SENSITIVITY_FRAME_LEN   6     /**<Command, the levels of channel 1~4 and the checksum*/
+
+#define POWER_OFF_TIME          200   /**<EN is held low this long to power cycle the sensor, unit: ms*/
+#define POWER_SETTLE_TIME       1000  /**<The sensor accepts commands this long after EN is high, unit: ms*/
+#define SELF_CHECK_UART_TIMEOUT 1000  /**<Self-check reply in UART detected mode, unit: ms*/
+#define SELF_CHECK_IO_TIMEOUT   1550  /**<Self-check reply after the TEST pulse in level one-to-one detection mode, unit: ms*/
+#define CALIB_TIMEOUT           1000  /**<Calibration ack or OUT pattern, unit: ms*/
+#define SENSITIVITY_TIMEOUT     2000  /**<Ack of the sensitivity frame, unit: ms*/
+
+class DFRobot_SCW8916B_Protocol{
+public:
+/**
+ * @brief The ack of a calibration command in UART detected mode: the command with its nibbles swapped.
+ */
+  static inline uint8_t calibrationAck(uint8_t cmd){ return (uint8_t)((cmd >> 4) | (cmd << 4)); }
+
+/**
+ * @brief Build the sensitivity frame.
+ * @param levels  The sensitivity levels of channel 1~4, 0~7.
+ * @param buf     The frame, SENSITIVITY_FRAME_LEN bytes.
+ * @return The length of the frame.
+ */
+  static inline uint8_t sensitivityFrame(const uint8_t levels[4], uint8_t *buf){
+    uint8_t cs = 0;
+    buf[0] = SENSITIVITY_CMD;
+    for(uint8_t i = 0; i < 4; i++){
+        buf[1 + i] = levels[i] & 0x07;
+        cs += buf[1 + i];
+    }
+    buf[5] = cs;
+    return SENSITIVITY_FRAME_LEN;
+  }
+
+/**
+ * @brief Watch of the OUT pin for the toggling of an uncalibrated sensor in level one-to-one detection mode:
+ * @n UNCALIB_TOGGLES toggles in a row, each within 1.5 * UNCALIB_TOGGLE_TIME of the previous one.
+ */
+typedef struct{
+  uint32_t edgeT;    /**<millis() of the last toggle*/
+  uint8_t toggles;   /**<Toggles in a row*/
+  uint8_t val;       /**<The last level*/
+}sToggleWatch_t;
+
+  static inline void toggleStart(sToggleWatch_t *w, uint8_t val, uint32_t now){
+    w->edgeT = now;
+    w->toggles = 0;
+    w->val = val;
+  }
+/**
+ * @return true: the sensor toggles like an uncalibrated one.
+ */
+  static inline bool toggleUpdate(sToggleWatch_t *w, uint8_t val, uint32_t now){
+    if(val == w->val) return false;
+    w->toggles = (now - w->edgeT <= UNCALIB_TOGGLE_TIME * 3 / 2) ? w->toggles + 1 : 1;
+    w->edgeT = now;
+    w->val = val;
+    return w->toggles >= UNCALIB_TOGGLES;
+  }
+
+/**
+ * @brief Watch of the OUT pin after the calibration pulse on TEST in level one-to-one detection mode: the sensor
+ * @n answers with a low period of about the pulse length followed by more than 500ms high.
+ */
+typedef struct{
+  uint32_t t1;        /**<millis() of the last edge*/
+  uint32_t interT1;   /**<Length of the last low period, 0: none yet*/
+  uint8_t val;        /**<The last level*/
+}sCalibWatch_t;
+
+  static inline void calibStart(sCalibWatch_t *w, uint8_t val, uint32_t now){
+    w->t1 = now;
+    w->interT1 = 0;
+    w->val = val;
+  }
+/**
+ * @param pulse  The length of the TEST pulse, CALIB_IO_TIME_LWL or CALIB_IO_TIME_UWL.
+ * @return true: the calibration pattern is complete.
+ */
+  static inline bool calibUpdate(sCalibWatch_t *w, uint8_t val, uint32_t now, uint8_t pulse){
+    if(val == w->val) return false;
+    if(w->val){
+        if(w->interT1 >= (uint32_t)(pulse - 10)){
+            if(now - w->t1 > 500) return true;
+            w->interT1 = 0;
+        }
+    }else{
+        w->interT1 = now - w->t1;
+    }
+    w->t1 = now;
+    w->val = val;
+    return false;
+  }
+};
+
+#endif
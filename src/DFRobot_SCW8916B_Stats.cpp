@@ -0,0 +1,48 @@
+/*!
+ * @file DFRobot_SCW8916B_Stats.cpp
+ * @brief Optional hot-path statistics of the SCW8916B library.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <Arduino.h>
+#include "DFRobot_SCW8916B_Stats.h"
+
+DFRobot_SCW8916B_Stats::DFRobot_SCW8916B_Stats(){
+  reset();
+}
+
+void DFRobot_SCW8916B_Stats::reset(){
+  memset(&data, 0, sizeof(data));
+  _lastTimeout = 0;
+}
+
+uint8_t DFRobot_SCW8916B_Stats::bucket(uint32_t us){
+  uint8_t b = 0;
+  while(b < SCW8916B_STATS_BUCKETS - 1 && us){
+      us >>= 2;
+      b++;
+  }
+  return b;
+}
+
+void DFRobot_SCW8916B_Stats::record(uint8_t op, uint32_t us, bool timeout){
+  sOpStats_t *p;
+  uint8_t b;
+  if(op >= eStatOpNum) return;
+  p = &data.op[op];
+  p->calls++;
+  if(_lastTimeout & (1 << op)) p->retries++;
+  if(timeout){
+      p->timeouts++;
+      _lastTimeout |= (1 << op);
+  }else{
+      _lastTimeout &= ~(1 << op);
+  }
+  b = bucket(us);
+  if(p->hist[b] != 0xFFFF) p->hist[b]++;
+}
@@ -0,0 +1,88 @@
+/*!
+ * @file DFRobot_SCW8916B_Stats.h
+ * @brief Optional hot-path statistics of the SCW8916B library: frame and byte counters, and the number of calls,
+ * @n timeouts, retries(a call after a timed out call of the same operation) and a latency histogram of every
+ * @n public operation.
+ * @n The statistics are compiled out unless SCW8916B_ENABLE_STATS is 1, then they cost no RAM, flash or cycles.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_STATS_H
+#define __DFRobot_SCW8916B_STATS_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+//Define SCW8916B_ENABLE_STATS, change 0 to 1 to compile the statistics in.
+#ifndef SCW8916B_ENABLE_STATS
+#define SCW8916B_ENABLE_STATS   0
+#endif
+
+#define SCW8916B_STATS_BUCKETS  12   /**<Bucket 0: 0us, bucket n: [4^(n-1), 4^n) us, bucket 11: 1.05s and longer*/
+
+typedef enum{
+  eStatBegin = 0,         /**<begin*/
+  eStatDetect,            /**<detectWater and detectWaterChannels*/
+  eStatPoll,              /**<poll*/
+  eStatSelfCheck,         /**<selfCheck and startSelfCheck*/
+  eStatCalibration,       /**<calibration and startCalibration*/
+  eStatSensitivity,       /**<setSensitivityLevel and startSetSensitivityLevel*/
+  eStatCheckCalibration,  /**<checkCalibrationState*/
+  eStatSample,            /**<sample and startSample*/
+  eStatOpNum
+}eStatOp_t;
+
+typedef struct{
+  uint32_t calls;                          /**<Completed calls*/
+  uint32_t timeouts;                       /**<Calls which ended without an answer of the sensor*/
+  uint32_t retries;                        /**<Calls which follow a timed out call of the same operation. The library never
+                                                re-sends a command by itself, this is the heuristic count of the retries
+                                                of the sketch*/
+  uint16_t hist[SCW8916B_STATS_BUCKETS];   /**<Latency histogram, saturates at 65535*/
+}sOpStats_t;
+
+typedef struct{
+  uint32_t bytesParsed;        /**<Bytes which are passed through the frame parser*/
+  uint32_t framesDecoded;      /**<Valid detection frames*/
+  uint32_t checksumFailures;   /**<Parsed bytes which fail the nibble complement check(neither frame, marker nor reply)*/
+  uint32_t bytesDiscarded;     /**<Bytes which are thrown away: the checksum failures and the bytes which are drained
+                                   unparsed while the sensor is power cycled*/
+  uint32_t eventsOverflowed;   /**<Detection frames which are dropped because the queue was full*/
+  sOpStats_t op[eStatOpNum];
+}sSCW8916BStats_t;
+
+class DFRobot_SCW8916B_Stats{
+public:
+  DFRobot_SCW8916B_Stats();
+/**
+ * @brief Record a completed call of an operation.
+ * @param op       eStatOp_t.
+ * @param us       The latency of the call, unit: us.
+ * @param timeout  The call ended without an answer of the sensor.
+ */
+  void record(uint8_t op, uint32_t us, bool timeout);
+/**
+ * @brief Clear every counter and histogram.
+ */
+  void reset();
+/**
+ * @brief The histogram bucket of a latency.
+ */
+  static uint8_t bucket(uint32_t us);
+
+  sSCW8916BStats_t data;
+
+private:
+  uint8_t _lastTimeout;   /**<bit n: the last call of operation n timed out*/
+  static_assert(eStatOpNum <= 8 * sizeof(_lastTimeout), "_lastTimeout needs one bit per eStatOp_t");
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*!
+ * @file DFRobot_SCW8916B_Store.h
+ * @brief Persistent storage of the sensor snapshot(self-check result and calibration state), so a warm boot
+ * @n can skip the self check and the calibration discovery.
+ * @n DFRobot_SCW8916B_Store is the storage interface, DFRobot_SCW8916B_EEPROMStore keeps the snapshot in the
+ * @n EEPROM of AVR, ESP8266 and ESP32, the host build provides a file store.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_STORE_H
+#define __DFRobot_SCW8916B_STORE_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#if defined(ARDUINO_ARCH_AVR) || defined(ESP8266) || defined(ESP32)
+#define SCW8916B_HAS_EEPROM
+#include <EEPROM.h>
+#endif
+
+#ifndef SCW8916B_EEPROM_SIZE
+#define SCW8916B_EEPROM_SIZE   512   /**<Size of the emulated EEPROM of ESP8266 and ESP32, unit: byte*/
+#endif
+
+class DFRobot_SCW8916B_Store{
+public:
+  virtual ~DFRobot_SCW8916B_Store(){}
+/**
+ * @brief Read the stored data.
+ * @param buf  The buffer of the data.
+ * @param len  The length of the data.
+ * @return true: read sucess, false: nothing is stored or read fail.
+ */
+  virtual bool read(void *buf, uint8_t len) = 0;
+/**
+ * @brief Store the data, only the bytes which are changed need to be written.
+ * @param buf  The data.
+ * @param len  The length of the data.
+ * @return true: write sucess, false: write fail.
+ */
+  virtual bool write(const void *buf, uint8_t len) = 0;
+};
+
+#ifdef SCW8916B_HAS_EEPROM
+class DFRobot_SCW8916B_EEPROMStore: public DFRobot_SCW8916B_Store{
+public:
+/**
+ * @brief DFRobot_SCW8916B_EEPROMStore constructor.
+ * @param addr  The EEPROM address of the snapshot, every sensor needs its own address.
+ * @param size  ESP8266 and ESP32: the size for EEPROM.begin, which the store calls once on its first access.
+ * @n     0: the sketch calls EEPROM.begin itself before the first warmBegin or selfCheck(needed if the sketch uses
+ * @n     the EEPROM as well, EEPROM.begin again would drop the buffer of the sketch and its uncommitted writes).
+ */
+  DFRobot_SCW8916B_EEPROMStore(int addr = 0, uint16_t size = SCW8916B_EEPROM_SIZE):_addr(addr),_size(size){}
+
+  bool read(void *buf, uint8_t len){
+    uint8_t *pBuf = (uint8_t *)buf;
+    setup();
+    for(uint8_t i = 0; i < len; i++){
+        pBuf[i] = EEPROM.read(_addr + i);
+    }
+    return true;
+  }
+
+  bool write(const void *buf, uint8_t len){
+    const uint8_t *pBuf = (const uint8_t *)buf;
+    setup();
+    for(uint8_t i = 0; i < len; i++){
+        if(EEPROM.read(_addr + i) != pBuf[i]){
+            EEPROM.write(_addr + i, pBuf[i]);
+        }
+    }
+#if defined(ESP8266) || defined(ESP32)
+    return EEPROM.commit();
+#else
+    return true;
+#endif
+  }
+private:
+  void setup(){
+#if defined(ESP8266) || defined(ESP32)
+    /* One EEPROM buffer for every store of the sketch, it is set up once. */
+    static bool begun = false;
+    if(!begun && _size){
+        EEPROM.begin(_size);
+    }
+    begun = true;
+#endif
+  }
+
+  int _addr;
+  uint16_t _size;
+};
+#endif
+
+#endif
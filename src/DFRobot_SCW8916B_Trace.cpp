@@ -0,0 +1,94 @@
+/*!
+ * @file DFRobot_SCW8916B_Trace.cpp
+ * @brief Binary trace of the traffic between the library and the sensor.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#include <Arduino.h>
+#include "DFRobot_SCW8916B_Trace.h"
+
+DFRobot_SCW8916B_Trace::DFRobot_SCW8916B_Trace(sTraceRecord_t *buf, uint16_t size)
+  :_buf(buf),_size(size),_lastUs(0),_started(false)
+{
+  clear();
+}
+
+void DFRobot_SCW8916B_Trace::clear(){
+  _head = 0;
+  _count = 0;
+  _dropped = 0;
+  _pinKnown[0] = _pinKnown[1] = 0;
+  _pinLevel[0] = _pinLevel[1] = 0;
+}
+
+void DFRobot_SCW8916B_Trace::push(uint16_t dt, uint8_t type, uint8_t val){
+  sTraceRecord_t *rec;
+  if(_buf == NULL || _size == 0) return;
+  rec = &_buf[_head];
+  rec->dt = dt;
+  rec->type = type;
+  rec->val = val;
+  _head = (_head + 1 < _size) ? _head + 1 : 0;
+  if(_count < _size){
+      _count++;
+  }else{
+      _dropped++;
+  }
+}
+
+void DFRobot_SCW8916B_Trace::record(uint8_t type, uint8_t val){
+  uint32_t now = micros();
+  uint32_t ticks = 0;
+  if(_started){
+      ticks = (now - _lastUs) / SCW8916B_TRACE_TICK_US;
+      _lastUs += ticks * SCW8916B_TRACE_TICK_US;
+  }else{
+      _lastUs = now;
+      _started = true;
+  }
+  if(ticks > 0xFFFF){
+      push((uint16_t)(ticks >> 16), eTraceTime, 0);
+  }
+  push((uint16_t)ticks, type, val);
+}
+
+void DFRobot_SCW8916B_Trace::recordPinRead(uint8_t pin, uint8_t level){
+  uint8_t i = (pin >> 5) & 0x01;
+  uint32_t bit = (uint32_t)1 << (pin & 0x1F);
+  level = level ? 1 : 0;
+  if(pin < 64 && (_pinKnown[i] & bit) && (((_pinLevel[i] & bit) != 0) == level)) return;
+  if(pin < 64){
+      _pinKnown[i] |= bit;
+      if(level) _pinLevel[i] |= bit;
+      else _pinLevel[i] &= ~bit;
+  }
+  record(eTracePinRead, (uint8_t)((pin << 1) | level));
+}
+
+const sTraceRecord_t *DFRobot_SCW8916B_Trace::get(uint16_t index) const{
+  uint16_t pos;
+  if(index >= _count) return NULL;
+  pos = (_head + _size - _count + index) % _size;
+  return &_buf[pos];
+}
+
+size_t DFRobot_SCW8916B_Trace::dump(Print *out) const{
+  uint8_t header[sizeof(sTraceHeader_t)] = {'S', 'C', 'W', 'T', SCW8916B_TRACE_VERSION, SCW8916B_TRACE_TICK_US,
+                                            (uint8_t)_count, (uint8_t)(_count >> 8),
+                                            (uint8_t)_dropped, (uint8_t)(_dropped >> 8),
+                                            (uint8_t)(_dropped >> 16), (uint8_t)(_dropped >> 24)};
+  size_t n;
+  if(out == NULL) return 0;
+  n = out->write(header, sizeof(header));
+  for(uint16_t i = 0; i < _count; i++){
+      const sTraceRecord_t *rec = get(i);
+      uint8_t buf[4] = {(uint8_t)rec->dt, (uint8_t)(rec->dt >> 8), rec->type, rec->val};
+      n += out->write(buf, sizeof(buf));
+  }
+  return n;
+}
@@ -0,0 +1,160 @@
+/*!
+ * @file DFRobot_SCW8916B_Trace.h
+ * @brief Binary trace of the traffic between the library and the sensor: every byte which is read from or written
+ * @n to the serial port, every level change which is read from a pin and every level which is written to a pin.
+ * @n The records have a fixed size of 4 bytes and a delta timestamp, they are kept in a ring buffer which is given by
+ * @n the user(the oldest records are overwritten), dump writes them in the trace file format to any Print.
+ * @n The library records into a trace set by setTrace when SCW8916B_ENABLE_TRACE is 1, the host build replays a
+ * @n trace file through the library on the virtual clock(extras/host/SCW8916B_Replay.h).
+ * @n File format, little endian: a block header(sTraceHeader_t) followed by header.count records, blocks can be appended.
+ *
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @licence     The MIT License (MIT)
+ * @author [Arya](xue.peng@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-04-22
+ * @https://github.com/DFRobot/DFRobot_SCW8916B
+ */
+#ifndef __DFRobot_SCW8916B_TRACE_H
+#define __DFRobot_SCW8916B_TRACE_H
+
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+//Define SCW8916B_ENABLE_TRACE, change 0 to 1 to compile the trace hooks of the library in.
+#ifndef SCW8916B_ENABLE_TRACE
+#define SCW8916B_ENABLE_TRACE   0
+#endif
+
+#define SCW8916B_TRACE_VERSION  1
+#define SCW8916B_TRACE_TICK_US  16   /**<Unit of the delta timestamp, a record covers up to 1.05s, unit: us*/
+
+typedef enum{
+  eTraceRx = 0,    /**<val: a byte which is read from the serial port*/
+  eTraceTx,        /**<val: a byte which is written to the serial port*/
+  eTracePinRead,   /**<val: pin << 1 | level, the level which is read from a pin has changed*/
+  eTracePinWrite,  /**<val: pin << 1 | level, a level is written to a pin*/
+  eTraceTime,      /**<No event, dt is in units of 65536 ticks, it extends the dt of the next record*/
+  eTraceMark       /**<No event, a time reference, for example the start of recording by setTrace*/
+}eTraceType_t;
+
+typedef struct{
+  uint16_t dt;     /**<Ticks since the previous record*/
+  uint8_t type;    /**<eTraceType_t*/
+  uint8_t val;
+}sTraceRecord_t;
+
+typedef struct{
+  uint8_t magic[4];    /**<"SCWT"*/
+  uint8_t version;     /**<SCW8916B_TRACE_VERSION*/
+  uint8_t tickUs;      /**<SCW8916B_TRACE_TICK_US*/
+  uint16_t count;      /**<Records in the block*/
+  uint32_t dropped;    /**<Records which were overwritten before this block was dumped*/
+}sTraceHeader_t;
+
+class DFRobot_SCW8916B_Trace{
+public:
+/**
+ * @brief DFRobot_SCW8916B_Trace constructor.
+ * @param buf   The ring buffer of the records.
+ * @param size  The number of records of the buffer.
+ */
+  DFRobot_SCW8916B_Trace(sTraceRecord_t *buf, uint16_t size);
+/**
+ * @brief Append a record, the oldest record is overwritten if the buffer is full.
+ * @param type  eTraceType_t.
+ * @param val   The byte or pin << 1 | level.
+ */
+  void record(uint8_t type, uint8_t val);
+/**
+ * @brief Record the level which is read from a pin, only if it differs from the last level read from the pin.
+ */
+  void recordPinRead(uint8_t pin, uint8_t level);
+/**
+ * @brief Drop all records, the time base is kept, so the next dump continues the previous one.
+ */
+  void clear();
+/**
+ * @brief The number of records in the buffer.
+ */
+  uint16_t count() const { return _count; }
+/**
+ * @brief The number of records which were overwritten since the last clear.
+ */
+  uint32_t dropped() const { return _dropped; }
+/**
+ * @brief Get a record.
+ * @param index  0 is the oldest record.
+ * @return The record, NULL if the index is out of range.
+ */
+  const sTraceRecord_t *get(uint16_t index) const;
+/**
+ * @brief Write the records as one block of the trace file format, for example to Serial or a file.
+ * @param out  The output.
+ * @return The number of bytes written.
+ */
+  size_t dump(Print *out) const;
+
+private:
+  void push(uint16_t dt, uint8_t type, uint8_t val);
+
+  sTraceRecord_t *_buf;
+  uint16_t _size;
+  uint16_t _head;
+  uint16_t _count;
+  uint32_t _dropped;
+  uint32_t _lastUs;      /**<micros() of the last record, rounded down to a tick*/
+  bool _started;
+  uint32_t _pinKnown[2]; /**<Pins 0~63 which have a recorded read level*/
+  uint32_t _pinLevel[2]; /**<The last recorded read level of the pins 0~63*/
+};
+
+/**
+ * @brief Stream which forwards to another stream and records every byte which is read or written.
+ */
+class DFRobot_SCW8916B_TraceStream: public Stream{
+public:
+  DFRobot_SCW8916B_TraceStream(Stream *s = NULL, DFRobot_SCW8916B_Trace *trace = NULL)
+    :_s(s),_trace(trace){}
+  void begin(Stream *s, DFRobot_SCW8916B_Trace *trace){
+    _s = s;
+    _trace = trace;
+  }
+/**
+ * @brief The stream which is wrapped.
+ */
+  Stream *stream(){ return _s; }
+
+  int available(){ return (_s != NULL) ? _s->available() : 0; }
+  int read(){
+    int val = (_s != NULL) ? _s->read() : -1;
+    if(val >= 0 && _trace != NULL) _trace->record(eTraceRx, (uint8_t)val);
+    return val;
+  }
+  int peek(){ return (_s != NULL) ? _s->peek() : -1; }
+  size_t write(uint8_t val){
+    if(_trace != NULL) _trace->record(eTraceTx, val);
+    return (_s != NULL) ? _s->write(val) : 0;
+  }
+  size_t write(const uint8_t *buffer, size_t size){
+    if(_trace != NULL){
+        for(size_t i = 0; i < size; i++){
+            _trace->record(eTraceTx, buffer[i]);
+        }
+    }
+    return (_s != NULL) ? _s->write(buffer, size) : 0;
+  }
+  using Print::write;
+  void flush(){
+    if(_s != NULL) _s->flush();
+  }
+
+private:
+  Stream *_s;
+  DFRobot_SCW8916B_Trace *_trace;
+};
+
+#endif